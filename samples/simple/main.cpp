@@ -166,6 +166,14 @@ int main(int argc, char** argv)
           // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
           // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
           SDL_Event event;
+          // nothing changed since the last frame: sleep until some input comes
+          if (!document.needsRedraw() && SDL_WaitEventTimeout(&event, 250))
+          {
+              ImGui_ImplSDL2_ProcessEvent(&event);
+              if (event.type == SDL_QUIT)
+                  done = true;
+          }
+
           while (SDL_PollEvent(&event))
           {
               ImGui_ImplSDL2_ProcessEvent(&event);
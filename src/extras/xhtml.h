@@ -472,7 +472,7 @@ namespace ImVue {
         }
 
         if(key[0] != '\0') {
-          bindListener(mScriptState->hash(key), NULL, Element::MODEL);
+          bindListener(mScriptState->hash(key), -1, Element::MODEL);
           invalidateFlags(Element::MODEL);
           mModel = ImStrdup(key);
         }
@@ -608,6 +608,11 @@ namespace ImVue {
 
   inline void registerHtmlExtras(ElementFactory& factory)
   {
+    // each component context registers extras on the same factory
+    if(factory.has("html")) {
+      return;
+    }
+
     factory.element<Html>("html");
     factory.element<HtmlContainer>("body");
     factory.element<HtmlContainer>("div");
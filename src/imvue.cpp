@@ -33,11 +33,13 @@ namespace ImVue {
 
   ComponentFactory::ComponentFactory()
     : mValid(false)
+    , mFunctional(false)
   {
   }
 
   ComponentFactory::ComponentFactory(Object definition)
     : mValid(false)
+    , mFunctional(false)
   {
     Object tmpl = definition["template"];
     if(!tmpl) {
@@ -53,6 +55,9 @@ namespace ImVue {
       }
     }
 
+    Object functional = definition["functional"];
+    mFunctional = functional.valid() && functional.as<bool>();
+
     mData = definition;
     mValid = true;
   }
@@ -106,11 +111,120 @@ namespace ImVue {
     }
   }
 
+  ComponentTemplate::ComponentTemplate(const char* data)
+    : mRefs(0)
+    , mMarked(false)
+    , mCache(NULL)
+  {
+    mSource = ImStrdup(data);
+    mRawData = ImStrdup(data);
+    try {
+      mDocument.parse<0>(mRawData);
+    } catch(...) {
+      ImGui::MemFree(mRawData);
+      ImGui::MemFree(mSource);
+      throw;
+    }
+  }
+
+  ComponentTemplate::~ComponentTemplate()
+  {
+    for(TemplateAttributesCache::iterator iter = mAttributeTables.begin(); iter != mAttributeTables.end(); ++iter) {
+      TemplateAttributes* attrs = iter->second;
+      while(attrs) {
+        TemplateAttributes* next = attrs->next;
+        delete attrs;
+        attrs = next;
+      }
+    }
+
+    mDocument.clear();
+    ImGui::MemFree(mRawData);
+    ImGui::MemFree(mSource);
+  }
+
+  void ComponentTemplate::release()
+  {
+    if(--mRefs > 0) {
+      return;
+    }
+
+    if(mCache) {
+      mCache->evictTemplate(this);
+    }
+    delete this;
+  }
+
+  const TemplateAttributes* ComponentTemplate::getAttributeTable(rapidxml::xml_node<>* node, const ElementBuilder* builder)
+  {
+    TemplateAttributes*& head = mAttributeTables[node];
+    for(TemplateAttributes* attrs = head; attrs; attrs = attrs->next) {
+      if(attrs->builder() == builder) {
+        if(attrs->outdated()) {
+          attrs->refresh();
+        }
+        return attrs;
+      }
+    }
+
+    TemplateAttributes* attrs = new TemplateAttributes(node, builder);
+    attrs->next = head;
+    head = attrs;
+    return attrs;
+  }
+
+  void ComponentTemplate::markStaticNodes(rapidxml::xml_node<>* root, ElementFactory* factory)
+  {
+    if(mMarked || !root || !factory) {
+      return;
+    }
+
+    for(rapidxml::xml_node<>* child = root->first_node(); child; child = child->next_sibling()) {
+      markStatic(child, factory);
+    }
+    mMarked = true;
+  }
+
+  bool ComponentTemplate::markStatic(rapidxml::xml_node<>* node, ElementFactory* factory)
+  {
+    bool res = true;
+    for(rapidxml::xml_node<>* child = node->first_node(); child; child = child->next_sibling()) {
+      res = markStatic(child, factory) && res;
+    }
+
+    const char* nodeName = node->name();
+    if(nodeName[0] == '\0') {
+      nodeName = TEXT_NODE;
+    }
+
+    // custom components have their own state
+    if(!factory->get(nodeName)) {
+      res = false;
+    }
+
+    for(const rapidxml::xml_attribute<>* a = node->first_attribute(); a && res; a = a->next_attribute()) {
+      const char* name = a->name();
+      if(name[0] == ':' || name[0] == '@' || std::strncmp(name, "v-", 2) == 0) {
+        res = false;
+      }
+    }
+
+    if(res && std::strstr(node->value(), "{{") != NULL) {
+      res = false;
+    }
+
+    if(res) {
+      mStaticNodes.insert(node);
+    }
+    return res;
+  }
+
   ComponentContainer::ComponentContainer()
     : mDocument(0)
-    , mRawData(NULL)
+    , mTemplate(NULL)
     , mMounted(false)
     , mRefs((int*)ImGui::MemAlloc(sizeof(int)))
+    , mBindingsState(NULL)
   {
     *mRefs = 1;
   }
@@ -134,17 +248,22 @@ namespace ImVue {
     fireCallback(ScriptState::BEFORE_DESTROY);
     removeChildren();
 
-    if(mRawData) {
-      ImGui::MemFree(mRawData);
+    releaseBindings();
+    releaseTemplate();
+    // templates still used elsewhere must not reach the destroyed cache
+    for(Templates::iterator iter = mTemplates.begin(); iter != mTemplates.end(); ++iter) {
+      iter->second->setCache(NULL);
     }
-
-    if(mDocument) {
-      delete mDocument;
+    mTemplates.clear();
+    fireCallback(ScriptState::DESTROYED);
+    // own subscriptions may belong to the state deleted with the context
+    if(mScriptState) {
+      mScriptState->removeListeners(this);
     }
 
-    fireCallback(ScriptState::DESTROYED);
     if(mCtx && mCtx->root == this) {
       delete mCtx;
+      mCtx = NULL;
     }
     mScriptState = 0;
   }
@@ -213,7 +332,11 @@ namespace ImVue {
       return NULL;
     }
 
-    Component* component = mComponents[nodeID].create();
+    Element* component = mComponents[nodeID].create(this);
+    if(!component) {
+      return NULL;
+    }
+
     try {
       component->configure(node, ctx, sctx, parent);
     } catch(...) {
@@ -225,21 +348,195 @@ namespace ImVue {
 
   void ComponentContainer::parseXML(const char* data)
   {
-    if(mRawData) {
-      ImGui::MemFree(mRawData);
+    mMounted = false;
+    removeChildren();
+    releaseBindings();
+    // document template is not shared
+    ComponentTemplate* tmpl = new ComponentTemplate(data);
+    setTemplate(tmpl);
+  }
+
+  void ComponentContainer::setTemplate(ComponentTemplate* tmpl)
+  {
+    tmpl->retain();
+    releaseTemplate();
+    mTemplate = tmpl;
+    mDocument = tmpl->document();
+  }
+
+  void ComponentContainer::releaseTemplate()
+  {
+    if(mTemplate) {
+      mTemplate->release();
     }
 
-    if(mDocument) {
-      delete mDocument;
+    mTemplate = NULL;
+    mDocument = NULL;
+    // own table belongs to the released template
+    mTemplateAttributes = 0;
+  }
+
+  ComponentTemplate* ComponentContainer::getNodeTemplate(rapidxml::xml_node<>* node)
+  {
+    rapidxml::xml_document<>* document = node->document();
+    if(document == mDocument) {
+      return mTemplate;
     }
 
-    mMounted = false;
-    removeChildren();
-    // create local copy of XML data for rapidxml to control the lifespan
-    mRawData = ImStrdup(data);
+    // component and slot nodes belong to the template of the container they are used in
+    if(mCtx && mCtx->parent && mCtx->parent->root) {
+      return mCtx->parent->root->getNodeTemplate(node);
+    }
+
+    // functional component nodes are rendered by the container using them
+    for(Templates::iterator iter = mTemplates.begin(); iter != mTemplates.end(); ++iter) {
+      if(iter->second->document() == document) {
+        return iter->second;
+      }
+    }
+
+    return mTemplate;
+  }
+
+  ComponentTemplate* ComponentContainer::loadTemplate(const char* source)
+  {
+    Context* top = mCtx;
+    while(top && top->parent) {
+      top = top->parent;
+    }
+
+    if(top && top->root && top->root != this) {
+      return top->root->loadTemplate(source);
+    }
+
+    ImU32 hash = ImHashStr(source);
+    Templates::iterator iter = mTemplates.find(hash);
+    if(iter != mTemplates.end() && std::strcmp(iter->second->source(), source) == 0) {
+      return iter->second;
+    }
+
+    ComponentTemplate* tmpl = new ComponentTemplate(source);
+    tmpl->setCache(this);
+    if(iter != mTemplates.end()) {
+      // hash collision, instances keep the previous template alive
+      iter->second->setCache(NULL);
+      iter->second = tmpl;
+    } else {
+      mTemplates[hash] = tmpl;
+    }
+    return tmpl;
+  }
+
+  void ComponentContainer::evictTemplate(ComponentTemplate* tmpl)
+  {
+    Templates::iterator iter = mTemplates.find(ImHashStr(tmpl->source()));
+    if(iter != mTemplates.end() && iter->second == tmpl) {
+      mTemplates.erase(iter);
+    }
+  }
+
+  void ComponentContainer::compileBindings(rapidxml::xml_node<>* root, ScriptState* script, ElementFactory* factory)
+  {
+    releaseBindings();
+    if(!root || !script || !factory) {
+      return;
+    }
+
+    mBindingsState = script;
+
+    std::vector<rapidxml::xml_node<>*> nodes;
+    nodes.push_back(root);
+    std::vector<std::string> sources;
+    ImVector<const char*> expressions;
+
+    while(nodes.size() > 0) {
+      rapidxml::xml_node<>* node = nodes.back();
+      nodes.pop_back();
+
+      for(rapidxml::xml_node<>* child = node->first_node(); child; child = child->next_sibling()) {
+        nodes.push_back(child);
+      }
+
+      const char* nodeName = node->name();
+      if(nodeName[0] == '\0') {
+        nodeName = TEXT_NODE;
+      }
+
+      const ElementBuilder* builder = factory->get(nodeName);
+      if(!builder) {
+        continue;
+      }
+
+      sources.clear();
+      // only attributes that are actually read by the element can be batched
+      for(const rapidxml::xml_attribute<>* a = node->first_attribute(); a; a = a->next_attribute()) {
+        const char* attrID = &a->name()[1];
+        if(a->name()[0] != ':' || a->value()[0] == '\0') {
+          continue;
+        }
+
+        if(builder->get(attrID) || ImStricmp(attrID, "class") == 0) {
+          sources.push_back(a->value());
+        }
+      }
+
+      if(builder->get(TEXT_ID)) {
+        const char* str = node->value();
+        const char* start = NULL;
+        for(int i = 0; str[i] != '\0'; ++i) {
+          if(start && std::strncmp(&str[i], "}}", 2) == 0) {
+            if(&str[i] != start) {
+              sources.push_back(std::string(start, &str[i] - start));
+            }
+            start = NULL;
+            i++;
+          } else if(!start && std::strncmp(&str[i], "{{", 2) == 0) {
+            start = &str[i + 2];
+            i++;
+          }
+        }
+      }
+
+      if(sources.size() == 0) {
+        continue;
+      }
+
+      expressions.clear();
+      for(size_t i = 0; i < sources.size(); ++i) {
+        expressions.push_back(sources[i].c_str());
+      }
+
+      int batch = script->compileBatch(expressions);
+      if(batch != 0) {
+        mBindings[node] = batch;
+      }
+    }
+  }
+
+  const TemplateAttributes* ComponentContainer::getAttributeTable(rapidxml::xml_node<>* node, const ElementBuilder* builder)
+  {
+    ComponentTemplate* tmpl = getNodeTemplate(node);
+    IM_ASSERT(tmpl && "template is not parsed");
+    return tmpl->getAttributeTable(node, builder);
+  }
+
+  void ComponentContainer::markStaticNodes(rapidxml::xml_node<>* root, ElementFactory* factory)
+  {
+    if(mTemplate) {
+      mTemplate->markStaticNodes(root, factory);
+    }
+  }
+
+  void ComponentContainer::releaseBindings()
+  {
+    if(mBindingsState) {
+      for(Bindings::iterator iter = mBindings.begin(); iter != mBindings.end(); ++iter) {
+        mBindingsState->releaseBatch(iter->second);
+      }
+    }
 
-    mDocument = new rapidxml::xml_document<>();
-    mDocument->parse<0>(mRawData);
+    mBindings.clear();
+    mBindingsState = NULL;
   }
 
   void ComponentContainer::renderBody() {
@@ -256,9 +553,20 @@ namespace ImVue {
       mMounted = true;
       fireCallback(ScriptState::MOUNTED);
     }
+
+    // side effects run after the whole tree is rendered
+    if(mCtx->script) {
+      mCtx->script->flushWatchers();
+    }
+
+    // return pages emptied by the subtrees destroyed in this frame
+    if(!mCtx->parent && mCtx->pool) {
+      mCtx->pool->trim();
+    }
   }
 
   Document::Document(Context* ctx)
+    : mRedrawFrames(0)
   {
     mCtx = ctx;
   }
@@ -267,6 +575,40 @@ namespace ImVue {
   {
   }
 
+  bool Document::needsRedraw() const
+  {
+    if(!mMounted || mRedrawFrames > 0) {
+      return true;
+    }
+
+    if(mCtx && (mCtx->redraw || (mCtx->script && mCtx->script->hasPendingChanges()))) {
+      return true;
+    }
+
+    return false;
+  }
+
+  void Document::renderBody()
+  {
+    mCtx->redraw = false;
+
+    ImGuiIO& io = ImGui::GetIO();
+    bool input = io.MouseDelta.x != 0 || io.MouseDelta.y != 0 || io.MouseWheel != 0 ||
+      io.InputQueueCharacters.size() > 0 || ImGui::IsAnyMouseDown() || ImGui::IsAnyItemActive();
+
+    for(int i = 0; !input && i < IM_ARRAYSIZE(io.KeysDown); ++i) {
+      input = io.KeysDown[i];
+    }
+
+    if(input) {
+      mRedrawFrames = IDLE_FRAMES;
+    } else if(mRedrawFrames > 0) {
+      --mRedrawFrames;
+    }
+
+    ComponentContainer::renderBody();
+  }
+
   void Document::parse(const char* data)
   {
     if(mCtx == 0) {
@@ -324,25 +666,32 @@ namespace ImVue {
 
     mNode = root->first_node("template");
     if(mNode) {
+      markStaticNodes(mNode, mCtx->factory);
+      compileBindings(mNode, mScriptState, mCtx->factory);
       configure(mNode, mCtx);
       fireCallback(ScriptState::CREATED);
     }
   }
 
-  Component* ComponentFactory::create()
+  Element* ComponentFactory::create(ComponentContainer* owner)
   {
     if(!mValid) {
       return NULL;
     }
 
-    return new Component(mTemplate, mProperties, mData);
+    ComponentTemplate* tmpl = owner->loadTemplate(mTemplate.get());
+    if(mFunctional) {
+      return new (owner->context()->pool) FunctionalComponent(tmpl, mProperties);
+    }
+
+    return new Component(tmpl, mProperties, mData);
   }
 
-  Component::Component(ImString tmpl, ComponentProperties& props, Object data)
+  Component::Component(ComponentTemplate* tmpl, ComponentProperties& props, Object data)
     : mProperties(props)
     , mData(data)
   {
-    parseXML(tmpl.get());
+    setTemplate(tmpl);
     mFlags = mFlags | Element::COMPONENT | Element::PSEUDO_ELEMENT;
   }
 
@@ -381,7 +730,6 @@ namespace ImVue {
       }
     }
 
-    removeChildren();
     mBuilder = mFactory->get("__element__");
     if(!Element::build()) {
       return false;
@@ -389,12 +737,10 @@ namespace ImVue {
 
     int flags = mConfigured ? 0 : Attribute::BIND_LISTENERS;
 
-    for(const rapidxml::xml_attribute<>* a = mNode->first_attribute(); a; a = a->next_attribute()) {
-      readProperty(a->name(), a->value(), flags);
+    const TemplateAttributes& attributes = getTemplateAttributes();
+    for(int i = 0; i < attributes.size(); ++i) {
+      readProperty(attributes[i], flags);
     }
-
-    // reading text
-    readProperty(TEXT_ID, mNode->value(), flags);
     if(ref && mScriptState) {
       mScriptState->addReference(ref, this);
     }
@@ -434,6 +780,9 @@ namespace ImVue {
       }
 
       mScriptState = ctx->script;
+      rapidxml::xml_node<>* tmpl = mDocument->first_node("template");
+      markStaticNodes(tmpl ? tmpl : mDocument, child->factory);
+      compileBindings(tmpl ? tmpl : mDocument, child->script, child->factory);
     } catch(...) {
       delete child;
       throw;
@@ -444,19 +793,24 @@ namespace ImVue {
     }
   }
 
-  bool Component::initAttribute(const char* attrID, const char* value, int flags, ScriptState::Fields* fields)
+  bool Component::initAttribute(const TemplateAttribute& attr, int flags, ScriptState::Fields* fields)
   {
-    ImU32 hash = ImHashStr(attrID);
+    const char* attrID = attr.id;
+    const char* value = attr.value;
 
-    if(mProperties.count(hash) == 0) {
+    if(mProperties.count(attr.hash) == 0) {
       return false;
     }
 
-    ComponentProperty& prop = mProperties[hash];
+    ComponentProperty& prop = mProperties[attr.hash];
     ScriptState& state = *mCtx->script;
 
     if((flags & Attribute::SCRIPT) && mScriptState) {
       Object result = mScriptState->getObject(value, fields, mScriptContext);
+      if(fields) {
+        // nested changes of the passed object should reach the component
+        mScriptState->addDeepFields(*fields);
+      }
       if(!prop.validate(result)) {
         IMVUE_EXCEPTION(ElementError, "[%s] field validation failed %s, got type: %d", getType(), attrID, result.type());
         return false;
@@ -471,4 +825,110 @@ namespace ImVue {
     return true;
   }
 
+  FunctionalComponent::FunctionalComponent(ComponentTemplate* tmpl, ComponentProperties& props)
+    : mTemplate(tmpl)
+    , mProperties(props)
+    , mProps(NULL)
+  {
+    mTemplate->retain();
+    mFlags = mFlags | Element::PSEUDO_ELEMENT;
+  }
+
+  FunctionalComponent::~FunctionalComponent()
+  {
+    // children keep the props context pointer
+    removeChildren();
+    if(mProps) {
+      delete mProps;
+    }
+    mTemplate->release();
+  }
+
+  void FunctionalComponent::configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx, Element* parent)
+  {
+    FunctionalComponent* self = this;
+    mProps = new ScriptState::Context(ImHashData(&self, sizeof(self), ImHashStr(node->name())));
+    for(ComponentProperties::iterator iter = mProperties.begin(); iter != mProperties.end(); ++iter) {
+      ComponentProperty& prop = iter->second;
+      mProps->add((char*)prop.id(), prop.def ? prop.def : Object::nil(), ScriptState::Variable::VALUE);
+    }
+
+    Element::configure(node, ctx, sctx, parent);
+  }
+
+  bool FunctionalComponent::build()
+  {
+    for(ComponentProperties::iterator iter = mProperties.begin(); iter != mProperties.end(); ++iter) {
+      ComponentProperty& prop = iter->second;
+      if(!prop.required || prop.def) {
+        continue;
+      }
+
+      if(!mNode->first_attribute(prop.attribute.get()) && !mNode->first_attribute(prop.id())) {
+        IMVUE_EXCEPTION(ElementError, "required property %s is not defined", prop.id());
+        return false;
+      }
+    }
+
+    mBuilder = mFactory->get("__element__");
+    if(!Element::build()) {
+      return false;
+    }
+
+    rapidxml::xml_document<>* document = mTemplate->document();
+    rapidxml::xml_node<>* tmpl = document->first_node("template");
+
+    // template elements are evaluated with the props context
+    ScriptState::Context* outer = mScriptContext;
+    mScriptContext = mProps;
+    try {
+      createChildren(tmpl ? tmpl : document);
+    } catch(...) {
+      mScriptContext = outer;
+      throw;
+    }
+    mScriptContext = outer;
+    return true;
+  }
+
+  bool FunctionalComponent::initAttribute(const TemplateAttribute& attr, int flags, ScriptState::Fields* fields)
+  {
+    if(mProperties.count(attr.hash) == 0) {
+      return Element::initAttribute(attr, flags, fields);
+    }
+
+    ComponentProperty& prop = mProperties[attr.hash];
+    Object value = Object::fromString(attr.value, strlen(attr.value));
+    if((flags & Attribute::SCRIPT) && mScriptState) {
+      value = mScriptState->getObject(attr.value, fields, mScriptContext);
+      if(fields) {
+        mScriptState->addDeepFields(*fields);
+      }
+    }
+
+    if(!prop.validate(value)) {
+      IMVUE_EXCEPTION(ElementError, "[%s] field validation failed %s, got type: %d", getType(), attr.id, value.type());
+      return false;
+    }
+
+    setProperty(prop.id(), value.valid() ? value : Object::nil());
+    return true;
+  }
+
+  void FunctionalComponent::setProperty(const char* id, Object value)
+  {
+    for(size_t i = 0; i < mProps->vars.size(); ++i) {
+      if(std::strcmp(mProps->vars[i].key, id) != 0) {
+        continue;
+      }
+
+      mProps->set(i, value);
+      // initial values are read by the template elements when they are created
+      if(mConfigured && mScriptState) {
+        mScriptState->pushChange(mProps->hash);
+      }
+      return;
+    }
+  }
+
 } // namespace ImVue
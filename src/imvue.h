@@ -28,10 +28,12 @@ SOFTWARE.
 #include "imgui_internal.h"
 #include "rapidxml.hpp"
 #include <iostream>
+#include <unordered_set>
 
 namespace ImVue {
 
   class Component;
+  class ComponentContainer;
 
   struct ComponentProperty {
     ImString attribute;
@@ -97,6 +99,74 @@ namespace ImVue {
     return NULL;
   }
 
+  /**
+   * Parsed template, shared by all the components created from the same source
+   * Nodes are never modified after parsing, so the per node caches are shared as well
+   */
+  class ComponentTemplate {
+    public:
+      ComponentTemplate(const char* data);
+      ~ComponentTemplate();
+
+      inline void retain() { ++mRefs; }
+
+      /**
+       * Delete the template and remove it from the cache when the last user releases it
+       */
+      void release();
+
+      /**
+       * Set the container which keeps the template in the cache
+       */
+      inline void setCache(ComponentContainer* cache) { mCache = cache; }
+
+      inline rapidxml::xml_document<>* document() { return &mDocument; }
+
+      /**
+       * Get unparsed template source
+       */
+      inline const char* source() const { return mSource; }
+
+      /**
+       * Get node attributes classified for the builder, classifies them on the first call
+       *
+       * @param node template node
+       * @param builder element builder
+       */
+      const TemplateAttributes* getAttributeTable(rapidxml::xml_node<>* node, const ElementBuilder* builder);
+
+      inline bool isStatic(rapidxml::xml_node<>* node) const {
+        return mStaticNodes.count(node) != 0;
+      }
+
+      /**
+       * Walks the template and collects nodes of the subtrees without any bindings, only once
+       *
+       * @param root template root, not marked itself
+       * @param factory element factory used to detect custom components
+       */
+      void markStaticNodes(rapidxml::xml_node<>* root, ElementFactory* factory);
+
+    private:
+      ComponentTemplate(const ComponentTemplate&);
+      ComponentTemplate& operator=(const ComponentTemplate&);
+
+      bool markStatic(rapidxml::xml_node<>* node, ElementFactory* factory);
+
+      rapidxml::xml_document<> mDocument;
+      // rapidxml parses in place
+      char* mRawData;
+      char* mSource;
+      int mRefs;
+      bool mMarked;
+      ComponentContainer* mCache;
+
+      typedef std::unordered_map<rapidxml::xml_node<>*, TemplateAttributes*> TemplateAttributesCache;
+      TemplateAttributesCache mAttributeTables;
+
+      std::unordered_set<rapidxml::xml_node<>*> mStaticNodes;
+  };
+
   /**
    * Loads component construction info
    * Can create new components of a type
@@ -109,7 +179,17 @@ namespace ImVue {
 
       ComponentFactory(Object definition);
 
-      Component* create();
+      /**
+       * Create component instance
+       *
+       * @param owner container that creates the component, provides the parsed templates cache
+       */
+      Element* create(ComponentContainer* owner);
+
+      /**
+       * Functional components have no state, they are rendered using the parent context
+       */
+      inline bool isFunctional() const { return mFunctional; }
 
     private:
 
@@ -121,6 +201,7 @@ namespace ImVue {
       ImString mTemplate;
       Object mData;
       bool mValid;
+      bool mFunctional;
   };
 
   class ComponentContainer : public ContainerElement {
@@ -137,10 +218,83 @@ namespace ImVue {
 
       void renderBody();
 
+      /**
+       * Get compiled bindings batch for the template node
+       *
+       * @param node template node
+       * @returns batch id, 0 if node has no compiled bindings
+       */
+      inline int getBindings(rapidxml::xml_node<>* node) const {
+        Bindings::const_iterator iter = mBindings.find(node);
+        return iter == mBindings.end() ? 0 : iter->second;
+      }
+
+      /**
+       * Get node attributes classified for the builder, classifies them on the first call
+       *
+       * @param node template node
+       * @param builder element builder
+       */
+      const TemplateAttributes* getAttributeTable(rapidxml::xml_node<>* node, const ElementBuilder* builder);
+
+      /**
+       * Check if template node and all its descendants have no bindings
+       *
+       * @param node template node
+       */
+      inline bool isStatic(rapidxml::xml_node<>* node) const {
+        return mTemplate && mTemplate->isStatic(node);
+      }
+
+      /**
+       * Get parsed template from the document wide cache, parses it on the first call
+       *
+       * @param source template source
+       */
+      ComponentTemplate* loadTemplate(const char* source);
+
+      /**
+       * Get count of the parsed templates kept in the cache
+       */
+      inline size_t getCachedTemplatesCount() const { return mTemplates.size(); }
+
+      /**
+       * Get parsed template the node belongs to
+       *
+       * @param node template node
+       */
+      ComponentTemplate* getNodeTemplate(rapidxml::xml_node<>* node);
+
     protected:
 
       void destroy();
 
+      /**
+       * Walks the template and compiles dynamic bindings of each node into a single batch
+       *
+       * @param root template root
+       * @param script script state to compile bindings with
+       * @param factory element factory used to detect readable attributes
+       */
+      void compileBindings(rapidxml::xml_node<>* root, ScriptState* script, ElementFactory* factory);
+
+      void releaseBindings();
+
+      /**
+       * Walks the template and collects nodes of the subtrees without any bindings
+       *
+       * @param root template root, not marked itself
+       * @param factory element factory used to detect custom components
+       */
+      void markStaticNodes(rapidxml::xml_node<>* root, ElementFactory* factory);
+
+      /**
+       * Use shared parsed template
+       */
+      void setTemplate(ComponentTemplate* tmpl);
+
+      void releaseTemplate();
+
       virtual bool build();
 
       /**
@@ -154,9 +308,10 @@ namespace ImVue {
 
       void parseXML(const char* data);
 
+      // owned by the template
       rapidxml::xml_document<>* mDocument;
 
-      char* mRawData;
+      ComponentTemplate* mTemplate;
       bool mMounted;
 
       /**
@@ -176,9 +331,10 @@ namespace ImVue {
       ComponentContainer(ComponentContainer& other)
         : ContainerElement(other)
         , mDocument(other.mDocument)
-        , mRawData(other.mRawData)
+        , mTemplate(other.mTemplate)
         , mMounted(other.mMounted)
         , mRefs(other.mRefs)
+        , mBindingsState(NULL)
       {
         (*mRefs)++;
       }
@@ -189,7 +345,7 @@ namespace ImVue {
       {
         std::swap(first.mRefs, second.mRefs);
         std::swap(first.mDocument, second.mDocument);
-        std::swap(first.mRawData, second.mRawData);
+        std::swap(first.mTemplate, second.mTemplate);
         std::swap(first.mMounted, second.mMounted);
       }
 
@@ -197,6 +353,19 @@ namespace ImVue {
       ComponentFactories mComponents;
       int* mRefs;
 
+      typedef std::unordered_map<rapidxml::xml_node<>*, int> Bindings;
+      Bindings mBindings;
+      ScriptState* mBindingsState;
+
+      // parsed component templates, filled in the top level document only,
+      // entries are not retained: templates remove themselves when released by the last component
+      typedef std::unordered_map<ImU32, ComponentTemplate*> Templates;
+      Templates mTemplates;
+
+    private:
+      friend class ComponentTemplate;
+
+      void evictTemplate(ComponentTemplate* tmpl);
   };
 
   /**
@@ -214,6 +383,20 @@ namespace ImVue {
        * @param data xml file, describing the document
        */
       void parse(const char* data);
+
+      /**
+       * Check if the next frame can differ from the last rendered one
+       * Idle applications can skip rendering or wait for input events while it returns false
+       */
+      bool needsRedraw() const;
+
+      void renderBody();
+
+    private:
+      // frames to render after the last input activity, ImGui updates some states one frame later
+      static const int IDLE_FRAMES = 2;
+
+      int mRedrawFrames;
   };
 
   /**
@@ -221,19 +404,43 @@ namespace ImVue {
    */
   class Component : public ComponentContainer {
     public:
-      Component(ImString tmpl, ComponentProperties& props, Object data);
+      Component(ComponentTemplate* tmpl, ComponentProperties& props, Object data);
       virtual ~Component();
 
       bool build();
 
-      void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx, Element* parent);
+      virtual void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
 
-      virtual bool initAttribute(const char* id, const char* value, int flags = 0, ScriptState::Fields* fields = 0);
+      virtual bool initAttribute(const TemplateAttribute& attr, int flags = 0, ScriptState::Fields* fields = 0);
 
     private:
       ComponentProperties& mProperties;
       Object mData;
   };
 
+  /**
+   * Stateless component
+   * Uses the parent context and script state, props are passed to the template as variables
+   */
+  class FunctionalComponent : public ContainerElement {
+    public:
+      FunctionalComponent(ComponentTemplate* tmpl, ComponentProperties& props);
+      virtual ~FunctionalComponent();
+
+      bool build();
+
+      virtual void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
+
+      virtual bool initAttribute(const TemplateAttribute& attr, int flags = 0, ScriptState::Fields* fields = 0);
+
+    private:
+      void setProperty(const char* id, Object value);
+
+      ComponentTemplate* mTemplate;
+      ComponentProperties& mProperties;
+      // props variables visible to the template elements
+      ScriptState::Context* mProps;
+  };
+
 } // namespace ImVue
 #endif
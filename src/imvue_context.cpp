@@ -145,6 +145,10 @@ namespace ImVue {
       if(fontManager) {
         delete fontManager;
       }
+
+      if(pool) {
+        delete pool;
+      }
     }
 
     if(script) {
@@ -156,7 +160,7 @@ namespace ImVue {
     }
   }
 
-  Context* createContext(ElementFactory* factory, ScriptState* script, TextureManager* texture, FileSystem* fs, FontManager* fontManager, Style* s, void* userdata)
+  static Context* initContext(ElementFactory* factory, ScriptState* script, TextureManager* texture, FileSystem* fs, FontManager* fontManager, Style* s, void* userdata)
   {
     Context* ctx = new Context();
     memset(ctx, 0, sizeof(Context));
@@ -179,6 +183,13 @@ namespace ImVue {
     return ctx;
   }
 
+  Context* createContext(ElementFactory* factory, ScriptState* script, TextureManager* texture, FileSystem* fs, FontManager* fontManager, Style* s, void* userdata)
+  {
+    Context* ctx = initContext(factory, script, texture, fs, fontManager, s, userdata);
+    ctx->pool = new ElementPool();
+    return ctx;
+  }
+
   Context* createContext(ElementFactory* factory, ScriptState* script, TextureManager* texture, FileSystem* fs, void* userdata)
   {
     FontManager* fontManager = new FontManager();
@@ -193,9 +204,158 @@ namespace ImVue {
     }
 
     Style* style = new Style(ctx->style);
-    Context* child = createContext(ctx->factory, script, ctx->texture, ctx->fs, ctx->fontManager, style, ctx->userdata);
+    Context* child = initContext(ctx->factory, script, ctx->texture, ctx->fs, ctx->fontManager, style, ctx->userdata);
     child->parent = ctx;
     child->scale = ctx->scale;
+    child->pool = ctx->pool;
     return child;
   }
+
+  ElementPool::ElementPool()
+    : mCurrentPage(-1)
+    , mEmptyPages(0)
+    , mCursor(NULL)
+    , mEnd(NULL)
+  {
+    memset(mFree, 0, sizeof(mFree));
+    memset(&mStats, 0, sizeof(mStats));
+  }
+
+  ElementPool::~ElementPool()
+  {
+    for(int i = 0; i < mPages.size(); ++i) {
+      if(mPages[i]) {
+        ImGui::MemFree(mPages[i]);
+      }
+    }
+    mPages.clear();
+  }
+
+  void* ElementPool::allocate(ElementPool* pool, size_t size)
+  {
+    // keep the block aligned the same way as the header
+    size_t total = (size + sizeof(Header) + GRANULARITY - 1) & ~(size_t)(GRANULARITY - 1);
+    Header* header = NULL;
+    if(pool && total / GRANULARITY <= SIZE_CLASSES) {
+      header = pool->alloc(total);
+    } else {
+      header = (Header*)ImGui::MemAlloc(total);
+      header->page = 0;
+      pool = NULL;
+    }
+
+    header->pool = pool;
+    header->size = (unsigned int)total;
+    return header + 1;
+  }
+
+  void ElementPool::release(void* ptr)
+  {
+    if(!ptr) {
+      return;
+    }
+
+    Header* header = (Header*)ptr - 1;
+    if(header->pool) {
+      header->pool->free(header);
+    } else {
+      ImGui::MemFree(header);
+    }
+  }
+
+  ElementPool::Header* ElementPool::alloc(size_t size)
+  {
+    int sizeClass = (int)(size / GRANULARITY) - 1;
+    Header* res = NULL;
+    if(mFree[sizeClass]) {
+      // freed blocks keep their page index
+      res = (Header*)mFree[sizeClass];
+      mFree[sizeClass] = mFree[sizeClass]->next;
+    } else {
+      if(mCursor == NULL || mCursor + size > mEnd) {
+        // the tail of the previous page is left unused
+        newPage();
+      }
+
+      res = (Header*)mCursor;
+      res->page = (unsigned int)mCurrentPage;
+      mCursor += size;
+    }
+
+    mPageBlocks[res->page]++;
+    mStats.used += size;
+    mStats.peak = ImMax(mStats.peak, mStats.used);
+    mStats.allocations++;
+    return res;
+  }
+
+  void ElementPool::free(Header* header)
+  {
+    size_t size = header->size;
+    int sizeClass = (int)(size / GRANULARITY) - 1;
+    if(--mPageBlocks[header->page] == 0 && (int)header->page != mCurrentPage) {
+      mEmptyPages++;
+    }
+
+    FreeBlock* block = (FreeBlock*)header;
+    block->next = mFree[sizeClass];
+    mFree[sizeClass] = block;
+
+    mStats.used -= size;
+    mStats.allocations--;
+  }
+
+  void ElementPool::newPage()
+  {
+    if(mCurrentPage >= 0 && mPageBlocks[mCurrentPage] == 0) {
+      mEmptyPages++;
+    }
+
+    int index = 0;
+    while(index < mPages.size() && mPages[index]) {
+      ++index;
+    }
+
+    if(index == mPages.size()) {
+      mPages.push_back(NULL);
+      mPageBlocks.push_back(0);
+    }
+
+    char* page = (char*)ImGui::MemAlloc(PAGE_SIZE);
+    mPages[index] = page;
+    mPageBlocks[index] = 0;
+    mCurrentPage = index;
+    mCursor = page;
+    mEnd = page + PAGE_SIZE;
+    mStats.reserved += PAGE_SIZE;
+  }
+
+  void ElementPool::trim()
+  {
+    if(mEmptyPages == 0) {
+      return;
+    }
+
+    // drop free blocks of the empty pages from the free lists
+    for(int i = 0; i < SIZE_CLASSES; ++i) {
+      FreeBlock** link = &mFree[i];
+      while(*link) {
+        unsigned int page = ((Header*)*link)->page;
+        if(mPageBlocks[page] == 0 && (int)page != mCurrentPage) {
+          *link = (*link)->next;
+        } else {
+          link = &(*link)->next;
+        }
+      }
+    }
+
+    for(int i = 0; i < mPages.size(); ++i) {
+      if(mPages[i] && mPageBlocks[i] == 0 && i != mCurrentPage) {
+        ImGui::MemFree(mPages[i]);
+        mPages[i] = NULL;
+        mStats.reserved -= PAGE_SIZE;
+      }
+    }
+    mEmptyPages = 0;
+  }
 }
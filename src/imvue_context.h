@@ -164,6 +164,84 @@ namespace ImVue {
       Fonts mFonts;
   };
 
+  /**
+   * Size class allocator for the elements
+   * Freed blocks are kept in per class free lists, pages left without live blocks
+   * after a subtree is destroyed are returned by trim
+   *
+   * Element strings and containers use the ImGui allocator
+   */
+  class ElementPool {
+    public:
+      struct Stats {
+        // bytes reserved by the pool pages
+        size_t reserved;
+        // bytes currently allocated from the pool
+        size_t used;
+        // max used bytes
+        size_t peak;
+        // live allocations
+        size_t allocations;
+      };
+
+      ElementPool();
+      ~ElementPool();
+
+      /**
+       * Allocate memory block
+       *
+       * @param pool pool to use, plain heap allocation if NULL
+       * @param size requested size
+       */
+      static void* allocate(ElementPool* pool, size_t size);
+
+      /**
+       * Return block to the pool it was allocated from
+       */
+      static void release(void* ptr);
+
+      /**
+       * Release pages which have no live blocks, does nothing if no page was emptied since the last call
+       */
+      void trim();
+
+      inline const Stats& getStats() const { return mStats; }
+
+    private:
+      struct Header {
+        ElementPool* pool;
+        unsigned int size;
+        // page index, kept intact while the block is in the free list
+        unsigned int page;
+      };
+
+      struct FreeBlock {
+        FreeBlock* next;
+      };
+
+      enum {
+        GRANULARITY = 16,
+        SIZE_CLASSES = 128,
+        PAGE_SIZE = 64 * 1024
+      };
+
+      Header* alloc(size_t size);
+
+      void free(Header* header);
+
+      void newPage();
+
+      FreeBlock* mFree[SIZE_CLASSES];
+      // released pages leave NULL slots, so the indices stored in the headers stay valid
+      ImVector<char*> mPages;
+      ImVector<int> mPageBlocks;
+      int mCurrentPage;
+      int mEmptyPages;
+      char* mCursor;
+      char* mEnd;
+      Stats mStats;
+  };
+
   /**
    * Object that keeps imvue configuration
    */
@@ -180,11 +258,27 @@ namespace ImVue {
       Style* style;
       FontManager* fontManager;
       Layout* layout;
+      // elements allocator, shared with the child contexts
+      ElementPool* pool;
       // additional userdata that will be available from all the components
       void* userdata;
 
       // adjust styles scale using this variable
       ImVec2 scale;
+
+      // set when the document output has changed since the last rendered frame
+      bool redraw;
+
+      /**
+       * Mark the top level document for redraw
+       */
+      inline void requestRedraw() {
+        Context* ctx = this;
+        while(ctx->parent) {
+          ctx = ctx->parent;
+        }
+        ctx->redraw = true;
+      }
   };
 
   /**
@@ -192,6 +286,11 @@ namespace ImVue {
    */
   Context* createContext(ElementFactory* factory, ScriptState* script = 0, TextureManager* texture = 0, FileSystem* fs = 0, void* userdata = 0);
 
+  /**
+   * Create new context using the provided font manager and style
+   */
+  Context* createContext(ElementFactory* factory, ScriptState* script, TextureManager* texture, FileSystem* fs, FontManager* fontManager, Style* s, void* userdata = 0);
+
   /**
    * Clone existing context
    */
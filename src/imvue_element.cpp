@@ -114,6 +114,11 @@ namespace ImVue {
   {
     bool hovered = mElement->isHovered();
     bool changed = mHovered != hovered;
+    return trigger(hovered, changed);
+  }
+
+  bool MouseEventHandler::trigger(bool hovered, bool changed)
+  {
     mHovered = hovered;
 
     if(!mHovered && !changed) {
@@ -227,9 +232,13 @@ namespace ImVue {
     , mParent(0)
     , mFactory(0)
     , mBuilder(0)
+    , mTemplateAttributes(0)
     , mTextureManager(0)
     , mClickHandler(NULL)
     , mScriptState(NULL)
+    , mSubscriptions(NULL)
+    , mDirtySlots(0)
+    , mDrawCache(NULL)
     , mCtx(0)
     , mScriptContext(0)
     , mStyle(this)
@@ -256,15 +265,11 @@ namespace ImVue {
       ImGui::MemFree(mClickHandler);
 
     if(mScriptState) {
-      for(Element::ReactiveFields::const_iterator iter = mReactiveFields.begin(); iter != mReactiveFields.end(); ++iter) {
-        bool success = mScriptState->removeListener(iter->first, this);
-        (void)success;
-        IM_ASSERT(success && "failed to remove listener");
-      }
+      mScriptState->removeListeners(this);
     }
 
-    for(Handlers::iterator iter = mHandlers.begin(); iter != mHandlers.end(); ++iter) {
-      delete iter->second;
+    for(int i = 0; i < mHandlers.size(); ++i) {
+      delete mHandlers[i].handler;
     }
     mHandlers.clear();
 
@@ -291,8 +296,12 @@ namespace ImVue {
       delete mScriptContext;
     }
 
-    for(Classes::iterator iter = classes.begin(); iter != classes.end(); iter++) {
-      ImGui::MemFree(iter->first);
+    if(mDrawCache) {
+      delete mDrawCache;
+    }
+
+    for(int i = 0; i < classes.size(); ++i) {
+      ImGui::MemFree(classes[i]);
     }
 
     classes.clear();
@@ -312,11 +321,36 @@ namespace ImVue {
     if(ImStricmp(node->name(), "window") == 0) {
       mFlags |= WINDOW;
     }
+
+    if(ctx->root && ctx->root->isStatic(node)) {
+      mFlags |= STATIC;
+    }
     mConfigured = build();
   }
 
   void Element::invalidate(const char* attribute) {
-    mDirtyProperties[attribute] = true;
+    int slot = getSlot(attribute);
+    if(slot >= 0) {
+      invalidateSlot(slot);
+    }
+  }
+
+  int Element::getSlot(const char* name) const {
+    if(strcmp(name, TEXT_ID) == 0) {
+      return TEXT_SLOT;
+    }
+
+    if(!mNode) {
+      return -1;
+    }
+
+    int slot = 0;
+    for(const rapidxml::xml_attribute<>* a = mNode->first_attribute(); a; a = a->next_attribute(), ++slot) {
+      if(strcmp(a->name(), name) == 0) {
+        return slot;
+      }
+    }
+    return -1;
   }
 
   const Attribute* Element::getAttribute(const char* attrID) const {
@@ -365,21 +399,32 @@ namespace ImVue {
   }
 
   void Element::setClasses(const char* cls, int flags, ScriptState::Fields* fields) {
-    for(Classes::iterator iter = classes.begin(); iter != classes.end(); iter++) {
-      ImGui::MemFree(iter->first);
+    for(int i = 0; i < classes.size(); ++i) {
+      ImGui::MemFree(classes[i]);
     }
 
     classes.clear();
     if(flags & Attribute::SCRIPT) {
       Object classesList = mScriptState->getObject(cls, fields, mScriptContext);
+      if(fields) {
+        // list content changes should also update classes
+        mScriptState->addDeepFields(*fields);
+      }
       for(Object::iterator iter = classesList.begin(); iter != classesList.end(); ++iter) {
-        classes[ImStrdup(iter.value.as<ImString>().c_str())] = true;
+        ImString value = iter.value.as<ImString>();
+        if(!hasClass(value.c_str())) {
+          classes.push_back(ImStrdup(value.c_str()));
+        }
       }
     } else {
       ImVector<char*> values;
       if(detail::parse_array(cls, values, ' ')) {
         for(int i = 0; i < values.size(); i++) {
-          classes[values[i]] = true;
+          if(hasClass(values[i])) {
+            ImGui::MemFree(values[i]);
+            continue;
+          }
+          classes.push_back(values[i]);
         }
       }
     }
@@ -439,45 +484,119 @@ namespace ImVue {
 
   void Element::invalidateFlags(unsigned int flags) {
     mInvalidFlags |= flags;
+    invalidateDrawCache();
+    if(mCtx) {
+      mCtx->requestRedraw();
+    }
+  }
+
+  void Element::restyleState(ElementState s)
+  {
+    // ImGui items look different when hovered or active even without any styles
+    invalidateDrawCache();
+    if(mCtx) {
+      mCtx->requestRedraw();
+    }
+
+    Style* style = mCtx ? mCtx->style : NULL;
+    if(!style || !mNode) {
+      invalidateFlags(Element::STYLE);
+      for(size_t i = 0; i < mChildren.size(); ++i) {
+        mChildren[i]->invalidateFlags(Element::STYLE);
+      }
+      return;
+    }
+
+    // :enabled also checks the enabled flag, which toggles together with HIDDEN
+    int state = (s & HIDDEN) ? (s | DISABLED) : s;
+    int dependency = style->stateDependency(this, state);
+    if(dependency & Style::STATE_SELF) {
+      invalidateFlags(Element::STYLE);
+    }
+
+    if(dependency & Style::STATE_DESCENDANTS) {
+      invalidateStateDependents(state);
+    }
   }
 
-  void Element::bindListeners(ScriptState::Fields& fields, const char* attribute, unsigned int flags)
+  void Element::invalidateStateDependents(int state)
+  {
+    for(size_t i = 0; i < mChildren.size(); ++i) {
+      Element* child = mChildren[i];
+      Style* style = child->mCtx ? child->mCtx->style : NULL;
+      if(!style || !child->mNode || style->dependsOnAncestorState(child, state)) {
+        child->invalidateFlags(Element::STYLE);
+      }
+      child->invalidateStateDependents(state);
+    }
+  }
+
+  void Element::invalidateDrawCache()
+  {
+    for(Element* e = this; e; e = e->mParent) {
+      if(e->mDrawCache) {
+        e->mDrawCache->invalidate();
+      }
+    }
+  }
+
+  void Element::setCache(bool value)
+  {
+    // windows output goes to their own draw lists
+    if(value && !mDrawCache && (mFlags & WINDOW) == 0) {
+      mDrawCache = new DrawCache();
+    } else if(!value && mDrawCache) {
+      delete mDrawCache;
+      mDrawCache = NULL;
+    }
+  }
+
+  void Element::splice(const ScriptState::Splice& splice)
+  {
+    (void)splice;
+    invalidateFlags(Element::BUILD);
+  }
+
+  void Element::bindListeners(ScriptState::Fields& fields, int slot, unsigned int flags)
   {
     for(int i = 0; i < fields.size(); ++i) {
-      bindListener(fields[i], attribute, flags);
+      bindListener(fields[i], slot, flags);
     }
   }
 
-  void Element::bindListener(ScriptState::FieldHash field, const char* attribute, unsigned int flags)
+  void Element::bindListener(ScriptState::FieldHash field, int slot, unsigned int flags)
   {
-    mScriptState->addListener(field, this, attribute, flags);
-    mReactiveFields[field] = true;
+    mScriptState->addListener(field, this, slot, flags);
   }
 
-  void Element::readProperty(const char* name, const char* value, int flags)
+  const TemplateAttributes& Element::getTemplateAttributes()
   {
-    const char* attrID = name;
-    if(ImStricmp(name, TEXT_ID) == 0) {
-      flags |= Attribute::TEMPLATED_STRING;
-    } else if(name[0] == ':') {
-      flags |= Attribute::SCRIPT;
-      attrID = &name[1];
+    if(!mTemplateAttributes || mTemplateAttributes->builder() != mBuilder || mTemplateAttributes->outdated()) {
+      IM_ASSERT(mCtx->root && "element must belong to a document");
+      mTemplateAttributes = mCtx->root->getAttributeTable(mNode, mBuilder);
     }
 
+    return *mTemplateAttributes;
+  }
+
+  void Element::readProperty(const TemplateAttribute& attr, int flags)
+  {
+    flags |= attr.flags;
+
     // process v-if v-else v-else-if v-for
-    if(ImStrnicmp(attrID, "v-else", 6) == 0 || ImStricmp(attrID, "v-if") == 0) {
+    if(attr.kind == TemplateAttribute::CONDITION || attr.kind == TemplateAttribute::ELSE) {
       if(enabledAttr) {
         ImGui::MemFree(enabledAttr);
       }
-      enabled = (mScriptState && ImStricmp(name, "v-else") != 0) ? mScriptState->getObject(value).as<bool>() : enabledAttr != NULL;
-      enabledAttr = ImStrdup(name);
+      enabled = (mScriptState && attr.kind != TemplateAttribute::ELSE) ? mScriptState->getObject(attr.value).as<bool>() : enabledAttr != NULL;
+      enabledAttr = ImStrdup(attr.name);
     }
 
     ScriptState::Fields fields;
-    bool initialized = initAttribute(attrID, value, flags, &fields);
+    bool initialized = initAttribute(attr, flags, &fields);
 
     if(flags & Attribute::BIND_LISTENERS && fields.size() > 0) {
-      bindListeners(fields, name);
+      bindListeners(fields, attr.slot);
     }
 
     if(initialized) {
@@ -485,29 +604,34 @@ namespace ImVue {
     }
 
     // check event listeners
-    if(std::strncmp(attrID, "v-on", 4) == 0) {
-      addHandler(name, value, mBuilder);
+    if(attr.kind == TemplateAttribute::HANDLER) {
+      addHandler(attr);
     }
   }
 
-  bool Element::initAttribute(const char* attrID, const char* value, int flags, ScriptState::Fields* fields)
+  bool Element::initAttribute(const TemplateAttribute& attr, int flags, ScriptState::Fields* fields)
   {
-    Attribute* reader = mBuilder->get(attrID);
-    if(reader) {
-      reader->read(attrID, value, this, mScriptState, flags, fields);
-      if(reader->required) {
+    if(attr.reader) {
+      attr.reader->read(attr.id, attr.value, this, mScriptState, flags, fields);
+      if(attr.reader->required) {
         mRequiredAttrsCount++;
       }
       return true;
     }
 
-    if(ImStricmp(attrID, "class") == 0) {
-      setClasses(value, flags, fields);
+    if(attr.kind == TemplateAttribute::CLASS) {
+      setClasses(attr.value, flags, fields);
     }
 
     return false;
   }
 
+  bool Element::beginBindings()
+  {
+    int batch = !isStatic() && mScriptState && mCtx->root && mScriptState == mCtx->script ? mCtx->root->getBindings(mNode) : 0;
+    return batch != 0 && mScriptState->beginBatch(batch, mScriptContext);
+  }
+
   bool Element::build()
   {
     if(!mBuilder) {
@@ -518,15 +642,28 @@ namespace ImVue {
       return false;
     }
 
-    int flags = mConfigured ? 0 : Attribute::BIND_LISTENERS;
+    // static elements have nothing to subscribe to
+    int flags = mConfigured || isStatic() ? 0 : Attribute::BIND_LISTENERS;
     mRequiredAttrsCount = 0;
 
-    for(const rapidxml::xml_attribute<>* a = mNode->first_attribute(); a; a = a->next_attribute()) {
-      readProperty(a->name(), a->value(), flags);
+    bool batched = beginBindings();
+
+    try {
+      // text is the last entry of the table
+      const TemplateAttributes& attributes = getTemplateAttributes();
+      for(int i = 0; i < attributes.size(); ++i) {
+        readProperty(attributes[i], flags);
+      }
+    } catch(...) {
+      if(batched) {
+        mScriptState->endBatch();
+      }
+      throw;
     }
 
-    // reading text
-    readProperty(TEXT_ID, mNode->value(), flags);
+    if(batched) {
+      mScriptState->endBatch();
+    }
     if(ref && mScriptState) {
       mScriptState->addReference(ref, this);
     }
@@ -558,6 +695,15 @@ namespace ImVue {
 
   void Element::render()
   {
+    // static elements are never patched: they have no subscriptions
+    if(!isStatic() && (mInvalidFlags & Element::PATCH)) {
+      // full rebuild makes patching redundant
+      if((mInvalidFlags & Element::BUILD) == 0 && !patch()) {
+        mInvalidFlags |= Element::BUILD;
+      }
+      mInvalidFlags &= ~Element::PATCH;
+    }
+
     if(mInvalidFlags & Element::BUILD) {
       mConfigured = build();
       mInvalidFlags ^= Element::BUILD;
@@ -612,7 +758,19 @@ namespace ImVue {
     }
 
     try {
-      renderBody();
+      // focused or hovered elements may look different on each frame
+      bool replayed = mDrawCache && (mState & (HOVERED | ACTIVE | FOCUSED)) == 0 && mDrawCache->replay();
+      if(!replayed) {
+        if(mDrawCache) {
+          mDrawCache->begin();
+        }
+
+        renderBody();
+
+        if(mDrawCache) {
+          mDrawCache->end();
+        }
+      }
     } catch (...) {
       mStyle.end();
       throw;
@@ -646,10 +804,19 @@ namespace ImVue {
       ImGui::PopID();
     }
 
-    if(mScriptState) {
-      for(Handlers::iterator iter = mHandlers.begin(); iter != mHandlers.end(); ++iter) {
-        if(iter->second->check()) {
-          mScriptState->eval(iter->second->getScript(), 0, 0, mScriptContext);
+    if(mFlags & MOUSE_EVENTS) {
+      // run in the element window and ID scope as the other handlers
+      dispatchMouseEvents(hovered);
+    }
+
+    if(mScriptState && !isStatic()) {
+      for(int i = 0; i < mHandlers.size(); ++i) {
+        if((mFlags & MOUSE_EVENTS) && mHandlers[i].handler->isMouseHandler()) {
+          continue;
+        }
+
+        if(mHandlers[i].handler->check()) {
+          mScriptState->eval(mHandlers[i].handler->getScript(), 0, 0, mScriptContext);
         }
       }
     }
@@ -662,82 +829,104 @@ namespace ImVue {
 
   void Element::computeProperties()
   {
-    if(mDirtyProperties.size() == 0) {
+    if(mDirtySlots == 0) {
       return;
     }
 
     bool wasEnabled = enabled;
+    uint64_t dirty = mDirtySlots;
+    mDirtySlots = 0;
+    ImVector<int> overflow;
+    overflow.swap(mDirtyOverflow);
+
+    const TemplateAttributes& attributes = getTemplateAttributes();
+    int evaluated = 0;
+    for(int i = 0; i < attributes.size(); ++i) {
+      if(isDirty(attributes[i].slot, dirty, overflow) &&
+          (attributes[i].flags & (Attribute::SCRIPT | Attribute::TEMPLATED_STRING))) {
+        evaluated++;
+      }
+    }
 
-    for(DirtyProperties::iterator iter = mDirtyProperties.begin(); iter != mDirtyProperties.end(); ++iter) {
-      char* value = NULL;
-      if(iter->first == TEXT_ID) {
-        value = mNode->value();
-      } else {
-        rapidxml::xml_attribute<>* attr = mNode->first_attribute(&iter->first[0]);
-        if(attr) {
-          value = attr->value();
+    // a single binding costs one script call either way
+    bool batched = evaluated > 1 && beginBindings();
+
+    try {
+      for(int i = 0; i < attributes.size(); ++i) {
+        if(isDirty(attributes[i].slot, dirty, overflow)) {
+          readProperty(attributes[i]);
         }
       }
-      if(value) {
-        readProperty(&iter->first[0], value);
+    } catch(...) {
+      if(batched) {
+        mScriptState->endBatch();
       }
+      throw;
+    }
+
+    if(batched) {
+      mScriptState->endBatch();
     }
-    mDirtyProperties.clear();
 
     if(wasEnabled != enabled && mParent) {
       mParent->invalidateFlags(Element::BUILD);
     }
 
-    fireCallback(ScriptState::UPDATED);
+    // called once per flush even if several elements were updated
+    fireCallback(ScriptState::UPDATED, true);
   }
 
-  void Element::addHandler(const char* name, const char* value, const ElementBuilder* builder)
+  void Element::addHandler(const TemplateAttribute& attr)
   {
     if(!mScriptState) {
       return;
     }
 
-    if(mHandlers.find(name) != mHandlers.end()) {
-      delete mHandlers[name];
-    }
-
-    // max handler id length is 256 symbols
-    const size_t bufferSize = 256;
-    char handlerName[bufferSize] = {0};
-    char fullName[bufferSize] = {0};
-    int state = 0;
-    size_t index = 0;
-
-    for(size_t i = 0; i < bufferSize && name[i] != '\0'; i++) {
-      switch(state) {
-        case 0:
-          if(name[i] == ':') {
-            state++;
-          }
-          break;
-        case 1:
-          if(name[i] == '.') {
-            state++;
-          } else {
-            handlerName[index] = name[i];
-          }
-        default:
-          fullName[index] = name[i];
-          index++;
+    int position = 0;
+    for(; position < mHandlers.size(); ++position) {
+      if(mHandlers[position].slot == attr.slot) {
+        delete mHandlers[position].handler;
+        mHandlers.erase(mHandlers.begin() + position);
+        break;
       }
     }
 
-    if(handlerName[0] == 0) {
-      IMVUE_EXCEPTION(ElementError, "malformed handler name %s", name);
+    if(attr.handlerName[0] == 0) {
+      IMVUE_EXCEPTION(ElementError, "malformed handler name %s", attr.name);
       return;
     }
 
-    EventHandler* handler = builder->createHandler(this, handlerName, fullName, value);
+    EventHandler* handler = attr.handler ? attr.handler->create(this, attr.fullName, attr.value) : NULL;
     if(!handler) {
-      IMVUE_EXCEPTION(ElementError, "failed to create handler of type %s", handlerName);
+      IMVUE_EXCEPTION(ElementError, "failed to create handler of type %s", attr.handlerName);
       return;
     }
-    mHandlers[name] = handler;
+    Handler entry = {attr.slot, handler};
+    mHandlers.insert(mHandlers.begin() + position, entry);
+    if(handler->isMouseHandler()) {
+      mFlags |= MOUSE_EVENTS;
+    }
+  }
+
+  void Element::dispatchMouseEvents(bool hovered)
+  {
+    bool changed = hovered != ((mFlags & MOUSE_HOVERED) != 0);
+    if(!hovered && !changed) {
+      return;
+    }
+
+    if(hovered) {
+      mFlags |= MOUSE_HOVERED;
+    } else {
+      mFlags &= ~MOUSE_HOVERED;
+    }
+
+    for(int i = 0; i < mHandlers.size(); ++i) {
+      EventHandler* handler = mHandlers[i].handler;
+      if(handler->isMouseHandler() && handler->trigger(hovered, changed)) {
+        mScriptState->eval(handler->getScript(), 0, 0, mScriptContext);
+      }
+    }
   }
 
   void Element::fireCallback(ScriptState::LifecycleCallbackType cb, bool schedule)
@@ -805,59 +994,131 @@ namespace ImVue {
     values.clear();
   }
 
+  bool ContainerElement::keyMatches(Element* element, rapidxml::xml_node<>* node)
+  {
+    // groups and condition chains do not have keys: v-for keys are resolved
+    // per row, conditional elements are kept by the chain
+    if(node->first_attribute("v-for") || node->first_attribute("v-if")) {
+      return true;
+    }
+
+    const char* key = NULL;
+    ImString evaluated;
+    rapidxml::xml_attribute<>* attr = node->first_attribute("key");
+    if(attr) {
+      key = attr->value();
+    } else if(mScriptState && (attr = node->first_attribute(":key")) != NULL) {
+      evaluated = mScriptState->getObject(attr->value(), NULL, mScriptContext).as<ImString>();
+      key = evaluated.get();
+    }
+
+    if(!key || !element->key) {
+      return key == element->key;
+    }
+
+    return std::strcmp(key, element->key) == 0;
+  }
+
   void ContainerElement::createChildren(rapidxml::xml_node<>* doc) {
     ScriptState::Fields fields;
     ConditionChain* chain = NULL;
+    bool reusedChain = false;
     rapidxml::xml_node<>* root = doc ? doc : mNode;
 
-    for (rapidxml::xml_node<>* node  = root->first_node(); node; node = node->next_sibling()) {
-      Element* e = NULL;
-      // v-for case is special: we don't need to create a single element for it
-      const rapidxml::xml_attribute<>* vfor = node->first_attribute("v-for");
-      if(vfor) {
-        if(!mScriptState) {
+    // children from the previous build are matched to the template nodes they
+    // were created from, only the nodes without a matching child are created
+    typedef std::unordered_map<rapidxml::xml_node<>*, Element*> ElementsByNode;
+    ElementsByNode previous;
+    previous.reserve(mChildren.size());
+    for(size_t i = 0; i < mChildren.size(); ++i) {
+      previous[mChildren[i]->node()] = mChildren[i];
+    }
+    mChildren.clear();
+
+    try {
+      for (rapidxml::xml_node<>* node  = root->first_node(); node; node = node->next_sibling()) {
+        if(reusedChain && (node->first_attribute("v-else-if") || node->first_attribute("v-else"))) {
+          // part of the reused chain
           continue;
         }
-        e = new ElementGroup();
-        try {
-          e->configure(node, mCtx, mScriptContext, this);
-        } catch(...) {
+        reusedChain = false;
+
+        ElementsByNode::iterator reused = previous.find(node);
+        if(reused != previous.end()) {
+          Element* e = reused->second;
+          previous.erase(reused);
+          if(keyMatches(e, node)) {
+            if(!node->first_attribute("v-for") && node->first_attribute("v-if")) {
+              // condition chain: conditions are re-evaluated, elements are kept
+              e->invalidateFlags(Element::BUILD);
+              reusedChain = true;
+            }
+            chain = NULL;
+            mChildren.push_back(e);
+            continue;
+          }
           delete e;
-          throw;
-        }
-      } else {
-        e = createElement(node, NULL, this);
-        if(!e) {
-          IMVUE_EXCEPTION(ElementError, "failed to create element '%s'", node->name());
-          continue;
         }
 
-        try {
-          if(e->enabledAttr != NULL) {
-            if(ImStricmp(e->enabledAttr, "v-if") == 0) {
-              chain = new ConditionChain();
-              chain->configure(node, mCtx, mScriptContext, this);
-              mChildren.push_back(chain);
-            }
+        Element* e = NULL;
+        // v-for case is special: we don't need to create a single element for it
+        const rapidxml::xml_attribute<>* vfor = node->first_attribute("v-for");
+        if(vfor) {
+          if(!mScriptState) {
+            continue;
+          }
+          e = new (mCtx->pool) ElementGroup();
+          try {
+            e->configure(node, mCtx, mScriptContext, this);
+          } catch(...) {
+            delete e;
+            throw;
+          }
+        } else {
+          e = createElement(node, NULL, this);
+          if(!e) {
+            IMVUE_EXCEPTION(ElementError, "failed to create element '%s'", node->name());
+            continue;
+          }
 
-            if(!chain) {
-              IMVUE_EXCEPTION(ElementError, "using v-else without v-if is not allowed");
-              return;
+          try {
+            if(e->enabledAttr != NULL) {
+              if(ImStricmp(e->enabledAttr, "v-if") == 0) {
+                chain = new (mCtx->pool) ConditionChain();
+                chain->configure(node, mCtx, mScriptContext, this);
+                mChildren.push_back(chain);
+              }
+
+              if(!chain) {
+                IMVUE_EXCEPTION(ElementError, "using v-else without v-if is not allowed");
+                delete e;
+                break;
+              }
+
+              chain->pushChild(e, node);
+              continue;
+            } else if(chain) {
+              chain = NULL;
             }
-
-            chain->pushChild(e, node);
-            continue;
-          } else if(chain) {
-            chain = NULL;
+          } catch(...) {
+            delete e;
+            throw;
           }
-        } catch(...) {
-          delete e;
-          throw;
         }
+
+        if(e)
+          mChildren.push_back(e);
+      }
+    } catch(...) {
+      for(ElementsByNode::iterator iter = previous.begin(); iter != previous.end(); ++iter) {
+        delete iter->second;
       }
+      throw;
+    }
 
-      if(e)
-        mChildren.push_back(e);
+    // destroy children which do not have template nodes anymore
+    for(ElementsByNode::iterator iter = previous.begin(); iter != previous.end(); ++iter) {
+      delete iter->second;
     }
   }
 
@@ -872,110 +1133,445 @@ namespace ImVue {
       return false;
     }
 
-    removeChildren();
     createChildren();
     return true;
   }
 
-  bool ElementGroup::build() {
-    const rapidxml::xml_attribute<>* vfor = mNode->first_attribute("v-for");
-    ImVector<char*> values;
-    if(!mScriptState->parseIterator(vfor->value(), values)) {
-      IMVUE_EXCEPTION(ScriptError, "failed to parse vfor %s", vfor->value());
-      return false;
+  ElementGroup::ElementGroup()
+    : mListHash(0)
+    , mListPath(0)
+    , mRowCounter(0)
+    , mValueIndex(-1)
+    , mKeyIndex(-1)
+    , mSubscribed(false)
+    , mCount(0)
+    , mItemHeight(0)
+    , mOverscan(2)
+    , mVirtual(false)
+  {
+  }
+
+  ElementGroup::~ElementGroup()
+  {
+    unsubscribe();
+    cleanupValues(mIterator);
+
+    if(mVirtual) {
+      // visible rows are owned by the rows map
+      mChildren.clear();
+      for(RowsMap::iterator iter = mRows.begin(); iter != mRows.end(); ++iter) {
+        delete iter->second;
+      }
+
+      for(size_t i = 0; i < mPool.size(); ++i) {
+        delete mPool[i];
+      }
     }
+  }
 
-    char* list = values[0];
-    char* valueVar = values[1];
-    char* keyVar = values[2];
+  void ElementGroup::unsubscribe()
+  {
+    if(mSubscribed) {
+      mScriptState->removeSpliceListener(mListPath, this);
+      mSubscribed = false;
+    }
+    mSplices.clear();
+  }
 
-    if(!list || !valueVar) {
-      cleanupValues(values);
-      IMVUE_EXCEPTION(ScriptError, "malformed vfor definition %s", vfor->value());
-      return false;
+  bool ElementGroup::build() {
+    if(mIterator.size() == 0) {
+      const rapidxml::xml_attribute<>* vfor = mNode->first_attribute("v-for");
+      if(!mScriptState->parseIterator(vfor->value(), mIterator)) {
+        cleanupValues(mIterator);
+        IMVUE_EXCEPTION(ScriptError, "failed to parse vfor %s", vfor->value());
+        return false;
+      }
+
+      if(!mIterator[0] || !mIterator[1]) {
+        cleanupValues(mIterator);
+        IMVUE_EXCEPTION(ScriptError, "malformed vfor definition %s", vfor->value());
+        return false;
+      }
+
+      mVirtual = mNode->first_attribute("virtual") != NULL;
+      if(mVirtual) {
+        const rapidxml::xml_attribute<>* attr = mNode->first_attribute("item-height");
+        mItemHeight = attr ? (float)atof(attr->value()) : 0.0f;
+        if(mItemHeight <= 0) {
+          cleanupValues(mIterator);
+          IMVUE_EXCEPTION(ElementError, "virtual v-for requires positive item-height");
+          return false;
+        }
+
+        attr = mNode->first_attribute("overscan");
+        if(attr) {
+          mOverscan = ImMax(atoi(attr->value()), 0);
+        }
+      }
     }
 
+    char* list = mIterator[0];
+
+    unsubscribe();
+
     ScriptState::Fields fields;
     Object object = mScriptState->getObject(list, &fields, mScriptContext);
     if(!object) {
-      cleanupValues(values);
       IMVUE_EXCEPTION(ScriptError, "object evaluation failed %s", list);
       return false;
     }
 
-    std::map<ScriptState::FieldHash, bool> visited;
-
-    ScriptState::FieldHash listHash = mScriptState->hash(list);
+    mListHash = mScriptState->hash(list);
 
-    size_t index = 0;
+    // arrays keyed 1..n can be patched by splice events
+    bool sequential = mScriptState->reactivePath(object, mListPath);
 
     mStyle.compute(this);
 
-    for(Object::iterator iter = object.begin(); iter != object.end(); ++iter, ++index) {
-
-      ScriptState::FieldHash hash = mScriptState->hash(iter.key.as<ImString>().get());
-
-      if(mElementsByKey.count(hash) != 0) {
-        Element* e = mElementsByKey[hash];
-        mChildren[index] = e;
-        mElementsByKey[hash] = e;
-        visited[hash] = true;
-        // update element
-        ScriptState::Context* c = e->getContext();
-        IM_ASSERT(c != NULL && "null context detected in the element");
-        if(c->vars.size() > 0 && c->vars[0].type == ScriptState::Variable::VALUE && c->vars[0].value.type() != ObjectType::NIL) {
-          c->vars[0].value = iter.value;
-          mScriptState->pushChange(c->hash);
-        }
-      } else {
-        ScriptState::FieldHash ctxHash = mScriptContext ? (mScriptContext->hash ^ listHash) : listHash;
+    if(mVirtual) {
+      return buildVirtual(object, fields);
+    }
 
-        ScriptState::Context* c = new ScriptState::Context(ctxHash, mScriptContext);
-        if(ImStricmp(valueVar, "_") != 0) {
-          c->add(valueVar, iter.value, ScriptState::Variable::VALUE);
-        }
+    // rows are matched by key, kept rows are moved into the new order
+    Elements rows;
+    rows.reserve(mChildren.size());
+    ElementsMap rowsByKey;
+    rowsByKey.reserve(mElementsByKey.size());
 
-        if(keyVar && ImStricmp(keyVar, "_") != 0) {
-          c->add(keyVar, iter.key, ScriptState::Variable::KEY);
+    try {
+      size_t index = 0;
+      for(Object::iterator iter = object.begin(); iter != object.end(); ++iter, ++index) {
+
+        ScriptState::FieldHash hash = mScriptState->hash(iter.key.as<ImString>().get());
+        sequential = sequential && iter.key.type() == ObjectType::NUMBER && iter.key.as<long>() == (long)index + 1;
+
+        Element* e = NULL;
+        ElementsMap::iterator existing = mElementsByKey.find(hash);
+        if(existing != mElementsByKey.end()) {
+          e = existing->second;
+          mElementsByKey.erase(existing);
+          // update element
+          ScriptState::Context* c = e->getContext();
+          IM_ASSERT(c != NULL && "null context detected in the element");
+          if(mValueIndex >= 0 && c->vars[mValueIndex].value.type() != ObjectType::NIL) {
+            c->set(mValueIndex, iter.value);
+            mScriptState->pushChange(c->hash);
+          }
+        } else {
+          e = createRow(iter.key, iter.value);
+          if(!e) {
+            replaceRows(rows, rowsByKey);
+            return false;
+          }
+          e->invalidateFlags(Element::STYLE);
         }
 
-        Element* e = createElement(mNode, c, this);
-        if(!e) {
-          IMVUE_EXCEPTION(ElementError, "failed to create element %s", mNode->name());
-          return false;
-        }
+        rowsByKey[hash] = e;
+        rows.push_back(e);
+      }
+    } catch(...) {
+      replaceRows(rows, rowsByKey);
+      throw;
+    }
 
-        if(index == mChildren.size()) {
-          mChildren.push_back(e);
-        } else {
-          mChildren[index] = e;
+    replaceRows(rows, rowsByKey);
+
+    if(sequential) {
+      // nested changes are handled by the rows, insertions and removals come as splices
+      mList = object;
+      mScriptState->addSpliceListener(mListPath, this);
+      mSubscribed = true;
+    } else {
+      // rebuild on any nested change of the list
+      mList = Object();
+      mScriptState->addDeepFields(fields);
+    }
+
+    bindListeners(fields, -1, Element::BUILD);
+    return true;
+  }
+
+  void ElementGroup::replaceRows(Elements& rows, ElementsMap& rowsByKey)
+  {
+    int structural = mCtx->style ? mCtx->style->structural() : 0;
+    if(structural) {
+      // only rows after the first changed position (or before the last one)
+      // can match different sibling selectors
+      size_t count = std::min(rows.size(), mChildren.size());
+      size_t head = 0;
+      while(head < count && rows[head] == mChildren[head]) {
+        ++head;
+      }
+
+      size_t tail = 0;
+      while(tail < count && rows[rows.size() - tail - 1] == mChildren[mChildren.size() - tail - 1]) {
+        ++tail;
+      }
+
+      for(size_t i = 0; i < rows.size(); ++i) {
+        bool preceding = (structural & Style::PRECEDING_SIBLINGS) && i >= head;
+        bool following = (structural & Style::FOLLOWING_SIBLINGS) && i + tail < rows.size();
+        if(preceding || following) {
+          rows[i]->invalidateFlags(Element::STYLE);
         }
+      }
+    }
+
+    // whatever was not matched is not in the list anymore
+    for(ElementsMap::iterator iter = mElementsByKey.begin(); iter != mElementsByKey.end(); ++iter) {
+      delete iter->second;
+    }
 
-        mElementsByKey[hash] = e;
-        visited[hash] = true;
+    mElementsByKey.swap(rowsByKey);
+    mChildren.swap(rows);
+  }
+
+  bool ElementGroup::buildVirtual(Object& list, ScriptState::Fields& fields)
+  {
+    mList = list;
+    mCount = list.size();
+
+    // rows in range are pointed to the new items, the rest are recycled
+    for(RowsMap::iterator iter = mRows.begin(); iter != mRows.end();) {
+      if((size_t)iter->first < mCount) {
+        assignRow(iter->second, iter->first);
+        ++iter;
+      } else {
+        mPool.push_back(iter->second);
+        iter = mRows.erase(iter);
       }
+    }
+
+    // visible rows are collected during render
+    mChildren.clear();
+
+    // only instantiated rows are refreshed, so any list change can rebuild
+    mScriptState->addDeepFields(fields);
+    bindListeners(fields, -1, Element::BUILD);
+    return true;
+  }
+
+  void ElementGroup::assignRow(Element* row, int index)
+  {
+    ScriptState::Context* c = row->getContext();
+    IM_ASSERT(c != NULL && "null context detected in the element");
 
-      mChildren[index]->invalidateFlags(Element::STYLE);
+    Object k = mScriptState->createInteger((long)index + 1);
+    if(mKeyIndex >= 0) {
+      c->set(mKeyIndex, k);
     }
 
-    for(size_t i = mChildren.size(); i > index; --i) {
-      mChildren.pop_back();
+    if(mValueIndex >= 0) {
+      c->set(mValueIndex, mList[k]);
     }
 
-    for(ElementsMap::iterator iter = mElementsByKey.begin(); iter != mElementsByKey.end();) {
-      if(!visited[iter->first]) {
-        delete iter->second;
-        mElementsByKey.erase(iter++);
+    // row is rendered in this frame, so it can't wait for the next flush
+    mScriptState->triggerListeners(c->hash);
+  }
+
+  void ElementGroup::renderBody()
+  {
+    if(mVirtual) {
+      renderVirtual();
+      // visible rows depend on the scroll position
+      invalidateDrawCache();
+    } else {
+      PseudoElement::renderBody();
+    }
+  }
+
+  void ElementGroup::renderVirtual()
+  {
+    ImGuiWindow* window = GetCurrentWindowNoDefault();
+    Layout* layout = mCtx->layout;
+    float origin = layout ? layout->nextLineY() : ImGui::GetCursorPosY();
+
+    int start = 0;
+    int end = 0;
+    if(window) {
+      float top = window->Pos.y - window->Scroll.y + origin;
+      start = (int)ImFloor((window->ClipRect.Min.y - top) / mItemHeight) - mOverscan;
+      end = (int)ImFloor((window->ClipRect.Max.y - top) / mItemHeight) + 1 + mOverscan;
+      start = ImClamp(start, 0, (int)mCount);
+      end = ImClamp(end, start, (int)mCount);
+    }
+
+    // rows which left the viewport are recycled
+    for(RowsMap::iterator iter = mRows.begin(); iter != mRows.end();) {
+      if(iter->first < start || iter->first >= end) {
+        mPool.push_back(iter->second);
+        iter = mRows.erase(iter);
       } else {
         ++iter;
       }
     }
 
-    cleanupValues(values);
-    bindListeners(fields, NULL, Element::BUILD);
+    mChildren.clear();
+    for(int i = start; i < end; ++i) {
+      Element* e = NULL;
+      RowsMap::iterator iter = mRows.find(i);
+      if(iter != mRows.end()) {
+        e = iter->second;
+      } else if(mPool.size() > 0) {
+        e = mPool.back();
+        mPool.pop_back();
+        assignRow(e, i);
+        mRows[i] = e;
+      } else {
+        Object k = mScriptState->createInteger((long)i + 1);
+        e = createRow(k, mList[k]);
+        if(!e) {
+          break;
+        }
+        mRows[i] = e;
+      }
+
+      float y = origin + i * mItemHeight;
+      if(layout) {
+        layout->moveTo(y);
+      } else {
+        ImGui::SetCursorPosY(y);
+      }
+
+      e->index = (int)mChildren.size();
+      mChildren.push_back(e);
+      e->render();
+    }
+
+    // reserve space for the whole list
+    float height = origin + mCount * mItemHeight;
+    if(layout) {
+      layout->moveTo(height);
+    } else {
+      ImGui::SetCursorPosY(height);
+    }
+  }
+
+  void ElementGroup::splice(const ScriptState::Splice& splice)
+  {
+    mSplices.push_back(splice);
+    invalidateFlags(Element::PATCH);
+  }
+
+  bool ElementGroup::patch()
+  {
+    if(!mSubscribed || !mConfigured) {
+      return false;
+    }
+
+    for(size_t i = 0; i < mSplices.size(); ++i) {
+      const ScriptState::Splice& splice = mSplices[i];
+      size_t count = mChildren.size();
+      if(splice.index < 0 || (size_t)splice.index > count || (splice.type != ScriptState::Splice::INSERT && (size_t)splice.index == count)) {
+        mSplices.clear();
+        return false;
+      }
+
+      size_t index = (size_t)splice.index;
+
+      switch(splice.type) {
+        case ScriptState::Splice::INSERT:
+          {
+            Element* e = createRow(mScriptState->createInteger((long)index + 1), splice.value);
+            if(!e) {
+              mSplices.clear();
+              return false;
+            }
+            e->invalidateFlags(Element::STYLE);
+            mChildren.insert(mChildren.begin() + index, e);
+            char key[32] = {0};
+            ImFormatString(key, 32, "%d", (int)index + 1);
+            mElementsByKey[mScriptState->hash(key)] = e;
+            reindex(index + 1);
+          }
+          break;
+        case ScriptState::Splice::REMOVE:
+          {
+            Element* e = mChildren[index];
+            mChildren.erase(mChildren.begin() + index);
+            char key[32] = {0};
+            ImFormatString(key, 32, "%d", (int)count);
+            mElementsByKey.erase(mScriptState->hash(key));
+            delete e;
+            reindex(index);
+          }
+          break;
+        case ScriptState::Splice::SET:
+          if(mValueIndex >= 0) {
+            ScriptState::Context* c = mChildren[index]->getContext();
+            c->set(mValueIndex, splice.value);
+            mScriptState->pushChange(c->hash);
+          }
+          break;
+      }
+    }
+
+    mSplices.clear();
     return true;
   }
 
+  Element* ElementGroup::createRow(Object key, Object value)
+  {
+    char* valueVar = mIterator[1];
+    char* keyVar = mIterator[2];
+
+    // each row gets own context hash, so updating a row does not re-evaluate the others
+    ScriptState::FieldHash listHash = mScriptContext ? (mScriptContext->hash ^ mListHash) : mListHash;
+    ScriptState::FieldHash ctxHash = ImHashData(&mRowCounter, sizeof(mRowCounter), listHash);
+    mRowCounter++;
+
+    ScriptState::Context* c = new ScriptState::Context(ctxHash, mScriptContext);
+    if(ImStricmp(valueVar, "_") != 0) {
+      mValueIndex = (int)c->vars.size();
+      c->add(valueVar, value, ScriptState::Variable::VALUE);
+    }
+
+    if(keyVar && ImStricmp(keyVar, "_") != 0) {
+      mKeyIndex = (int)c->vars.size();
+      c->add(keyVar, key, ScriptState::Variable::KEY);
+    }
+
+    Element* e = createElement(mNode, c, this);
+    if(!e) {
+      IMVUE_EXCEPTION(ElementError, "failed to create element %s", mNode->name());
+      return NULL;
+    }
+
+    return e;
+  }
+
+  void ElementGroup::reindex(size_t from)
+  {
+    int structural = mCtx->style ? mCtx->style->structural() : 0;
+    if(structural & Style::FOLLOWING_SIBLINGS) {
+      for(size_t i = 0; i < from && i < mChildren.size(); ++i) {
+        mChildren[i]->invalidateFlags(Element::STYLE);
+      }
+    }
+
+    char key[32] = {0};
+    for(size_t i = from; i < mChildren.size(); ++i) {
+      Element* e = mChildren[i];
+      if(structural & Style::PRECEDING_SIBLINGS) {
+        e->invalidateFlags(Element::STYLE);
+      }
+      ImFormatString(key, 32, "%d", (int)i + 1);
+      mElementsByKey[mScriptState->hash(key)] = e;
+
+      ScriptState::Context* c = e->getContext();
+      Object k = mScriptState->createInteger((long)i + 1);
+      if(mKeyIndex >= 0) {
+        c->set(mKeyIndex, k);
+      }
+
+      // shifted rows should read the item by the new index
+      if(mValueIndex >= 0) {
+        c->set(mValueIndex, mList[k]);
+      }
+      mScriptState->pushChange(c->hash);
+    }
+  }
+
   ConditionChain::ConditionChain()
     : mEnabledElement(NULL)
     , mDefault(NULL)
@@ -1003,7 +1599,7 @@ namespace ImVue {
       mAttributes.push_back(a);
       ScriptState::Fields fields;
       mScriptState->getObject(a->value(), &fields, mScriptContext);
-      bindListeners(fields, NULL, Element::BUILD);
+      bindListeners(fields, -1, Element::BUILD);
     }
 
     mChildren.push_back(element);
@@ -1048,6 +1644,254 @@ namespace ImVue {
     }
   }
 
+  DrawCache::DrawCache()
+    : mDrawList(NULL)
+    , mWindow(NULL)
+    , mTexture(NULL)
+    , mVtxStart(0)
+    , mIdxStart(0)
+    , mCmdCount(0)
+    , mChildWindows(0)
+    , mActiveWindows(0)
+    , mOpenPopups(0)
+    , mVtxCurrentIdx(0)
+    , mRecording(false)
+    , mValid(false)
+  {
+  }
+
+  void DrawCache::begin()
+  {
+    mValid = false;
+    mWindow = GetCurrentWindowNoDefault();
+    if(!mWindow) {
+      return;
+    }
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    mDrawList = drawList;
+    mOrigin = ImGui::GetCursorScreenPos();
+    mVtxStart = drawList->VtxBuffer.Size;
+    mIdxStart = drawList->IdxBuffer.Size;
+    mCmdCount = drawList->CmdBuffer.Size;
+    mVtxCurrentIdx = drawList->_VtxCurrentIdx;
+    mChildWindows = mWindow->DC.ChildWindows.Size;
+    ImGuiContext& g = *ImGui::GetCurrentContext();
+    mActiveWindows = g.WindowsActiveCount;
+    mOpenPopups = g.OpenPopupStack.Size;
+    mClipRect = drawList->_ClipRectStack.Size ? drawList->_ClipRectStack.back() : ImVec4(0, 0, 0, 0);
+    mTexture = drawList->_TextureIdStack.Size ? drawList->_TextureIdStack.back() : NULL;
+    mRecording = true;
+  }
+
+  void DrawCache::end()
+  {
+    if(!mRecording) {
+      return;
+    }
+
+    mRecording = false;
+    ImGuiWindow* window = GetCurrentWindowNoDefault();
+    if(window != mWindow || ImGui::GetWindowDrawList() != mDrawList) {
+      return;
+    }
+
+    ImDrawList* drawList = mDrawList;
+    int vtxCount = drawList->VtxBuffer.Size - mVtxStart;
+    int idxCount = drawList->IdxBuffer.Size - mIdxStart;
+
+    // new draw commands mean clip rect or texture changes, child windows are drawn separately
+    if(drawList->CmdBuffer.Size != mCmdCount ||
+        drawList->_VtxCurrentIdx - mVtxCurrentIdx != (unsigned int)vtxCount ||
+        window->DC.ChildWindows.Size != mChildWindows) {
+      return;
+    }
+
+    // popups, tooltips and nested windows are drawn into their own draw lists
+    // and disappear if Begin is not called on replay
+    ImGuiContext& g = *ImGui::GetCurrentContext();
+    if(g.WindowsActiveCount != mActiveWindows || g.OpenPopupStack.Size != mOpenPopups) {
+      return;
+    }
+
+    mVertices.resize(vtxCount);
+    mIndices.resize(idxCount);
+    mItemRect = ImRect(window->DC.LastItemRect.Min - mOrigin, window->DC.LastItemRect.Max - mOrigin);
+    mBounds = mItemRect;
+    for(int i = 0; i < vtxCount; ++i) {
+      ImDrawVert& v = mVertices[i];
+      v = drawList->VtxBuffer[mVtxStart + i];
+      v.pos = v.pos - mOrigin;
+      mBounds.Add(v.pos);
+    }
+
+    for(int i = 0; i < idxCount; ++i) {
+      mIndices[i] = (ImDrawIdx)(drawList->IdxBuffer[mIdxStart + i] - mVtxCurrentIdx);
+    }
+
+    mCursor = window->DC.CursorPos - mOrigin;
+    mCursorMax = window->DC.CursorMaxPos - mOrigin;
+    mValid = true;
+  }
+
+  bool DrawCache::replay()
+  {
+    if(!mValid || ImGui::IsAnyItemActive()) {
+      return false;
+    }
+
+    ImGuiWindow* window = GetCurrentWindowNoDefault();
+    if(!window) {
+      return false;
+    }
+
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec4 clipRect = drawList->_ClipRectStack.Size ? drawList->_ClipRectStack.back() : ImVec4(0, 0, 0, 0);
+    ImTextureID texture = drawList->_TextureIdStack.Size ? drawList->_TextureIdStack.back() : NULL;
+    if(texture != mTexture ||
+        clipRect.x != mClipRect.x || clipRect.y != mClipRect.y ||
+        clipRect.z != mClipRect.z || clipRect.w != mClipRect.w) {
+      mValid = false;
+      return false;
+    }
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    if(ImGui::IsMouseHoveringRect(mBounds.Min + origin, mBounds.Max + origin, false)) {
+      return false;
+    }
+
+    if(mVertices.size() > 0) {
+      drawList->PrimReserve(mIndices.size(), mVertices.size());
+      ImDrawIdx base = (ImDrawIdx)drawList->_VtxCurrentIdx;
+      for(int i = 0; i < mVertices.size(); ++i) {
+        ImDrawVert& v = drawList->_VtxWritePtr[i];
+        v = mVertices[i];
+        v.pos = v.pos + origin;
+      }
+
+      for(int i = 0; i < mIndices.size(); ++i) {
+        drawList->_IdxWritePtr[i] = (ImDrawIdx)(base + mIndices[i]);
+      }
+
+      drawList->_VtxWritePtr += mVertices.size();
+      drawList->_IdxWritePtr += mIndices.size();
+      drawList->_VtxCurrentIdx += mVertices.size();
+    }
+
+    // emulate the item submitted by the body
+    ImRect bb(mItemRect.Min + origin, mItemRect.Max + origin);
+    ImGui::ItemSize(bb);
+    ImGui::ItemAdd(bb, 0);
+    window->DC.CursorPos = mCursor + origin;
+    window->DC.CursorMaxPos = ImMax(window->DC.CursorMaxPos, mCursorMax + origin);
+    return true;
+  }
+
+  TemplateAttributes::TemplateAttributes(rapidxml::xml_node<>* node, const ElementBuilder* builder)
+    : next(NULL)
+    , mBuilder(builder)
+    , mGeneration(builder->generation())
+  {
+    int slot = 0;
+    for(const rapidxml::xml_attribute<>* a = node->first_attribute(); a; a = a->next_attribute(), ++slot) {
+      add(a->name(), a->value(), slot);
+    }
+
+    // reading text
+    add(TEXT_ID, node->value(), Element::TEXT_SLOT);
+  }
+
+  TemplateAttributes::~TemplateAttributes()
+  {
+    for(int i = 0; i < mAttributes.size(); ++i) {
+      if(mAttributes[i].handlerName) {
+        ImGui::MemFree(mAttributes[i].handlerName);
+        ImGui::MemFree(mAttributes[i].fullName);
+      }
+    }
+    mAttributes.clear();
+  }
+
+  bool TemplateAttributes::outdated() const
+  {
+    return mGeneration != mBuilder->generation();
+  }
+
+  void TemplateAttributes::refresh()
+  {
+    for(int i = 0; i < mAttributes.size(); ++i) {
+      TemplateAttribute& attr = mAttributes[i];
+      attr.reader = mBuilder->get(attr.id);
+      if(attr.kind == TemplateAttribute::HANDLER) {
+        attr.handler = mBuilder->getHandler(attr.handlerName);
+      }
+    }
+    mGeneration = mBuilder->generation();
+  }
+
+  void TemplateAttributes::add(const char* name, const char* value, int slot)
+  {
+    TemplateAttribute attr;
+    memset(&attr, 0, sizeof(TemplateAttribute));
+    attr.name = name;
+    attr.id = name;
+    attr.value = value;
+    attr.slot = slot;
+    attr.kind = TemplateAttribute::PROPERTY;
+
+    if(slot == Element::TEXT_SLOT) {
+      attr.flags |= Attribute::TEMPLATED_STRING;
+    } else if(name[0] == ':') {
+      attr.flags |= Attribute::SCRIPT;
+      attr.id = &name[1];
+    }
+
+    if(ImStrnicmp(attr.id, "v-else", 6) == 0 || ImStricmp(attr.id, "v-if") == 0) {
+      attr.kind = ImStricmp(name, "v-else") == 0 ? TemplateAttribute::ELSE : TemplateAttribute::CONDITION;
+    } else if(std::strncmp(attr.id, "v-on", 4) == 0) {
+      attr.kind = TemplateAttribute::HANDLER;
+    } else if(ImStricmp(attr.id, "class") == 0) {
+      attr.kind = TemplateAttribute::CLASS;
+    }
+
+    attr.hash = ImHashStr(attr.id);
+    attr.reader = mBuilder->get(attr.id);
+
+    if(attr.kind == TemplateAttribute::HANDLER) {
+      // max handler id length is 256 symbols
+      const size_t bufferSize = 256;
+      char handlerName[bufferSize] = {0};
+      char fullName[bufferSize] = {0};
+      int state = 0;
+      size_t index = 0;
+
+      for(size_t i = 0; i < bufferSize - 1 && name[i] != '\0'; i++) {
+        switch(state) {
+          case 0:
+            if(name[i] == ':') {
+              state++;
+            }
+            break;
+          case 1:
+            if(name[i] == '.') {
+              state++;
+            } else {
+              handlerName[index] = name[i];
+            }
+          default:
+            fullName[index] = name[i];
+            index++;
+        }
+      }
+
+      attr.handlerName = ImStrdup(handlerName);
+      attr.fullName = ImStrdup(fullName);
+      attr.handler = mBuilder->getHandler(handlerName);
+    }
+
+    mAttributes.push_back(attr);
+  }
+
   int ElementBuilder::getLayer(ElementFactory* f) {
     int layer = 0;
     if(mInheritance.size() != 0) {
@@ -1085,6 +1929,7 @@ namespace ImVue {
     for(Layers::iterator iter = mLayers.begin(); iter != mLayers.end(); ++iter) {
       for(ElementBuilders::iterator it = iter->second.begin(); it != iter->second.end(); ++it) {
         it->second->readInheritance(this);
+        it->second->finalize();
       }
     }
   }
@@ -34,14 +34,15 @@ SOFTWARE.
 #include "imvue_layout.h"
 #include <vector>
 #include <map>
+#include <climits>
 #include <iostream>
 #include <cstring>
 #include <sstream>
 #include <unordered_map>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <tchar.h>
-#include <algorithm>
 #else
 #include <stdlib.h>
 #include <ctype.h>
@@ -432,6 +433,135 @@ namespace ImVue {
   class ElementFactory;
   class EventHandler;
   class ElementBuilder;
+  class HandlerFactory;
+
+  /**
+   * Node attribute classified against the element builder
+   */
+  struct TemplateAttribute {
+    enum Kind {
+      PROPERTY,
+      // v-if, v-else-if
+      CONDITION,
+      // v-else
+      ELSE,
+      // v-on:...
+      HANDLER,
+      CLASS
+    };
+
+    // attribute name as written in the template
+    const char* name;
+    // attribute name without the binding prefix
+    const char* id;
+    const char* value;
+    // builder attribute reader, NULL if the builder has none
+    Attribute* reader;
+    // handler factory and parsed handler names for HANDLER attributes
+    HandlerFactory* handler;
+    char* handlerName;
+    char* fullName;
+    ImU32 hash;
+    int flags;
+    int slot;
+    Kind kind;
+  };
+
+  /**
+   * All attributes of the node classified once per element builder
+   */
+  class TemplateAttributes {
+    public:
+      TemplateAttributes(rapidxml::xml_node<>* node, const ElementBuilder* builder);
+      ~TemplateAttributes();
+
+      inline int size() const { return mAttributes.size(); }
+
+      inline const TemplateAttribute& operator[](int index) const { return mAttributes[index]; }
+
+      inline const ElementBuilder* builder() const { return mBuilder; }
+
+      /**
+       * Readers and handlers were registered again after the table was built
+       */
+      bool outdated() const;
+
+      /**
+       * Resolve readers and handler factories again from the builder
+       */
+      void refresh();
+
+      // next table of the same node built for another builder
+      TemplateAttributes* next;
+
+    private:
+      void add(const char* name, const char* value, int slot);
+
+      ImVector<TemplateAttribute> mAttributes;
+      const ElementBuilder* mBuilder;
+      unsigned int mGeneration;
+  };
+
+  /**
+   * Recorded draw list output of the element body
+   * Replayed with the offset of the current cursor position while nothing changes
+   */
+  class DrawCache {
+    public:
+      DrawCache();
+
+      /**
+       * Start recording
+       */
+      void begin();
+
+      /**
+       * Stop recording, output is kept only if it went into a single draw command
+       * and no other window or popup was begun by the body
+       */
+      void end();
+
+      /**
+       * Append recorded output to the current window draw list
+       *
+       * @returns false if the output has to be rendered again
+       */
+      bool replay();
+
+      inline void invalidate() {
+        mValid = false;
+        // changes made while recording are not in the recorded output
+        mRecording = false;
+      }
+
+      inline bool valid() const { return mValid; }
+
+    private:
+      ImVector<ImDrawVert> mVertices;
+      // indices relative to the first recorded vertex
+      ImVector<ImDrawIdx> mIndices;
+
+      ImDrawList* mDrawList;
+      ImGuiWindow* mWindow;
+      ImVec4 mClipRect;
+      ImTextureID mTexture;
+      // all coordinates below are relative to the recording origin
+      ImVec2 mOrigin;
+      ImRect mItemRect;
+      ImRect mBounds;
+      ImVec2 mCursor;
+      ImVec2 mCursorMax;
+
+      int mVtxStart;
+      int mIdxStart;
+      int mCmdCount;
+      int mChildWindows;
+      int mActiveWindows;
+      int mOpenPopups;
+      unsigned int mVtxCurrentIdx;
+      bool mRecording;
+      bool mValid;
+  };
 
   /**
    * Represents basic scene element
@@ -444,7 +574,8 @@ namespace ImVue {
       enum InvalidationFlag {
         BUILD = 1 << 0,
         STYLE = 1 << 1,
-        MODEL = 1 << 2
+        MODEL = 1 << 2,
+        PATCH = 1 << 3
       };
 
       // mutually excluding element states
@@ -464,14 +595,34 @@ namespace ImVue {
         PSEUDO_ELEMENT  = 1 << 1,
         COMPONENT       = 1 << 2,
         WINDOW          = 1 << 3,
-        BUTTON          = 1 << 4
+        BUTTON          = 1 << 4,
+        // element and all its children have no bindings
+        STATIC          = 1 << 5,
+        // element has mouse handlers, they are run with the hover state computed by render
+        MOUSE_EVENTS    = 1 << 6,
+        // mouse handlers have seen the element hovered
+        MOUSE_HOVERED   = 1 << 7
       };
 
-      typedef std::unordered_map<ScriptState::FieldHash, bool> ReactiveFields;
+      // attribute slots are node attribute indices, text has a reserved slot
+      enum Slot {
+        // attributes starting from this one share the overflow dirty bit,
+        // the dirty ones are listed separately
+        OVERFLOW_SLOT = 62,
+        TEXT_SLOT     = INT_MAX
+      };
 
       Element();
       virtual ~Element();
 
+      /**
+       * Elements are allocated from the context pool when it is available
+       */
+      static void* operator new(size_t size) { return ElementPool::allocate(NULL, size); }
+      static void* operator new(size_t size, ElementPool* pool) { return ElementPool::allocate(pool, size); }
+      static void operator delete(void* ptr) { ElementPool::release(ptr); }
+      static void operator delete(void* ptr, ElementPool*) { ElementPool::release(ptr); }
+
       /**
        * Element render
        */
@@ -542,7 +693,7 @@ namespace ImVue {
        * @param sctx Additional script context (used in iterator)
        * @param parent parent element
        */
-      void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
+      virtual void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
 
       /**
        * Trigger evaluation of the property which is linked with field id
@@ -551,6 +702,32 @@ namespace ImVue {
        */
       void invalidate(const char* id);
 
+      /**
+       * Trigger evaluation of the attribute by slot
+       *
+       * @param slot attribute slot
+       */
+      inline void invalidateSlot(int slot) {
+        mDirtySlots |= slotMask(slot);
+        if(slot >= OVERFLOW_SLOT && slot != TEXT_SLOT && !mDirtyOverflow.contains(slot)) {
+          mDirtyOverflow.push_back(slot);
+        }
+        invalidateDrawCache();
+        if(mCtx) {
+          mCtx->requestRedraw();
+        }
+      }
+
+      /**
+       * Drop recorded draw output of the element and all its parents
+       */
+      void invalidateDrawCache();
+
+      /**
+       * Enable draw output caching for the element subtree
+       */
+      void setCache(bool value);
+
       /**
        * Trigger invalidation of some specific kind
        *
@@ -558,6 +735,14 @@ namespace ImVue {
        */
       void invalidateFlags(unsigned int flags);
 
+      /**
+       * Handle structural change of the array the element is subscribed to
+       * Element is rebuilt by default
+       *
+       * @param splice splice event
+       */
+      virtual void splice(const ScriptState::Splice& splice);
+
       /**
        * Check if Element is container
        */
@@ -572,6 +757,13 @@ namespace ImVue {
         return (mFlags & Element::PSEUDO_ELEMENT) != 0;
       }
 
+      /**
+       * Check if Element belongs to the static subtree
+       */
+      inline bool isStatic() const {
+        return (mFlags & Element::STATIC) != 0;
+      }
+
       /**
        * Get attribute interface by field id
        *
@@ -628,9 +820,22 @@ namespace ImVue {
 
       bool isHovered(ImGuiHoveredFlags flags = 0) const;
 
+      /**
+       * Run mouse handlers which are triggered by the hover state
+       * Does nothing if the element is not hovered and was not hovered before
+       *
+       * @param hovered element is under the cursor
+       */
+      void dispatchMouseEvents(bool hovered);
+
       inline bool hasClass(const char* cls) const
       {
-        return classes.find(const_cast<char*>(cls)) != classes.end();
+        for(int i = 0; i < classes.size(); ++i) {
+          if(strcmp(classes[i], cls) == 0) {
+            return true;
+          }
+        }
+        return false;
       }
 
       inline ComputedStyle* style() {
@@ -711,26 +916,58 @@ namespace ImVue {
 
       ImU32 bgColor;
 
-      typedef std::map<char*, bool, CmpChar> Classes;
+      typedef ImVector<char*> Classes;
       Classes classes;
 
     protected:
 
       friend class ContainerElement;
+      friend class ScriptState;
+
+      void bindListeners(ScriptState::Fields& fields, int slot = -1, unsigned int flags = 0);
+
+      void bindListener(ScriptState::FieldHash field, int slot = -1, unsigned int flags = 0);
+
+      /**
+       * Get attribute slot by name, -1 if the node has no such attribute
+       */
+      int getSlot(const char* name) const;
 
-      void bindListeners(ScriptState::Fields& fields, const char* attribute = 0, unsigned int flags = 0);
+      /**
+       * Get dirty mask bit of the slot
+       */
+      static inline uint64_t slotMask(int slot) {
+        return (uint64_t)1 << (slot == TEXT_SLOT ? 63 : ImMin(slot, (int)OVERFLOW_SLOT));
+      }
 
-      void bindListener(ScriptState::FieldHash field, const char* attribute = 0, unsigned int flags = 0);
+      /**
+       * Check if the attribute slot has to be re-read
+       */
+      static inline bool isDirty(int slot, uint64_t dirty, const ImVector<int>& overflow) {
+        return (dirty & slotMask(slot)) != 0 &&
+          (slot < OVERFLOW_SLOT || slot == TEXT_SLOT || overflow.contains(slot));
+      }
 
-      typedef std::unordered_map<std::string, bool> DirtyProperties;
+      /**
+       * Get node attributes classified for the element builder
+       * Tables are cached by the root container, so it is done once per template node
+       */
+      const TemplateAttributes& getTemplateAttributes();
 
       virtual Element* createElement(rapidxml::xml_node<>* node, ScriptState::Context* sctx = 0, Element* parent = 0);
 
       virtual bool build();
 
-      void readProperty(const char* name, const char* value, int flags = 0);
+      /**
+       * Apply queued changes without full rebuild
+       *
+       * @returns false if the element should be rebuilt
+       */
+      virtual bool patch() { return false; }
+
+      void readProperty(const TemplateAttribute& attr, int flags = 0);
 
-      virtual bool initAttribute(const char* id, const char* value, int flags = 0, ScriptState::Fields* fields = 0);
+      virtual bool initAttribute(const TemplateAttribute& attr, int flags = 0, ScriptState::Fields* fields = 0);
 
       /**
        * Renders actual element data
@@ -744,45 +981,62 @@ namespace ImVue {
 
       void fireCallback(ScriptState::LifecycleCallbackType cb, bool schedule = false);
 
-      void addHandler(const char* name, const char* value, const ElementBuilder* builder);
+      void addHandler(const TemplateAttribute& attr);
 
       inline void setState(ElementState s)
       {
         if((mState & s) == 0) {
           mState |= s;
-          invalidateFlags(Element::STYLE);
-
-          for(size_t i = 0; i < mChildren.size(); ++i) {
-            mChildren[i]->invalidateFlags(Element::STYLE);
-          }
+          restyleState(s);
         }
       }
 
       inline void resetState(ElementState s) {
         if((mState & s) != 0) {
           mState ^= s;
-          invalidateFlags(Element::STYLE);
-
-          for(size_t i = 0; i < mChildren.size(); ++i) {
-            mChildren[i]->invalidateFlags(Element::STYLE);
-          }
+          restyleState(s);
         }
       }
 
+      /**
+       * Invalidate styles of the element and descendants having selectors with the state pseudo-class
+       */
+      void restyleState(ElementState s);
+
+      void invalidateStateDependents(int state);
+
+      /**
+       * Evaluate compiled node bindings in a single script call
+       *
+       * @returns true if the batch is active and endBatch should be called
+       */
+      bool beginBindings();
+
       rapidxml::xml_node<>* mNode;
 
-      typedef std::map<const char*, EventHandler*> Handlers;
+      struct Handler {
+        int slot;
+        EventHandler* handler;
+      };
+
+      typedef ImVector<Handler> Handlers;
 
       Handlers mHandlers;
       Elements mChildren;
       Element* mParent;
       ElementFactory* mFactory;
       ElementBuilder* mBuilder;
+      const TemplateAttributes* mTemplateAttributes;
       TextureManager* mTextureManager;
       char* mClickHandler;
       ScriptState* mScriptState;
-      ReactiveFields mReactiveFields;
-      DirtyProperties mDirtyProperties;
+      // intrusive list of the field subscriptions
+      ScriptState::Subscription* mSubscriptions;
+      // bit per attribute slot to re-read
+      uint64_t mDirtySlots;
+      // dirty slots sharing the overflow bit
+      ImVector<int> mDirtyOverflow;
+      DrawCache* mDrawCache;
       Context* mCtx;
       ScriptState::Context* mScriptContext;
       ComputedStyle mStyle;
@@ -1045,19 +1299,26 @@ namespace ImVue {
       virtual Element* create(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx, Element* parent = 0) const = 0;
 
       inline Attribute* get(const char* name) const {
-        if(mAttributes.find(name) != mAttributes.end()) {
-          return mAttributes.at(name);
+        if(mFinalized) {
+          return lookup(mAttributeTable, name);
         }
 
-        return nullptr;
+        Attributes::const_iterator iter = mAttributes.find(name);
+        return iter == mAttributes.end() ? nullptr : iter->second;
       }
 
-      inline EventHandler* createHandler(Element* element, const char* name, const char* fullName, const char* script) const {
-        if(mHandlers.find(name) != mHandlers.end()) {
-          return mHandlers.at(name)->create(element, fullName, script);
+      inline HandlerFactory* getHandler(const char* name) const {
+        if(mFinalized) {
+          return lookup(mHandlerTable, name);
         }
 
-        return nullptr;
+        Handlers::const_iterator iter = mHandlers.find(name);
+        return iter == mHandlers.end() ? nullptr : iter->second;
+      }
+
+      inline EventHandler* createHandler(Element* element, const char* name, const char* fullName, const char* script) const {
+        HandlerFactory* factory = getHandler(name);
+        return factory ? factory->create(element, fullName, script) : nullptr;
       }
 
       const ElementBuilder::RequiredAttrs& getRequiredAttrs() const
@@ -1065,10 +1326,79 @@ namespace ImVue {
         return mRequiredAttrs;
       }
 
+      /**
+       * Incremented each time an attribute or a handler is registered,
+       * pointers cached from previous generations may be deleted
+       */
+      inline unsigned int generation() const {
+        return mGeneration;
+      }
+
     protected:
 
       friend class ElementFactory;
 
+      ElementBuilder()
+        : mFinalized(false)
+        , mGeneration(0)
+      {
+      }
+
+      /**
+       * Table entry sorted by the name hash
+       */
+      template<class T>
+      struct Entry {
+        ImU32 hash;
+        const char* name;
+        T* value;
+
+        bool operator<(const Entry& other) const { return hash < other.hash; }
+      };
+
+      template<class T>
+      static T* lookup(const ImVector<Entry<T> >& table, const char* name) {
+        ImU32 hash = ImHashStr(name);
+        int lo = 0;
+        int hi = table.size();
+        while(lo < hi) {
+          int mid = (lo + hi) / 2;
+          if(table[mid].hash < hash) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
+        }
+
+        // names are compared only to rule out hash collisions
+        for(; lo < table.size() && table[lo].hash == hash; ++lo) {
+          if(std::strcmp(table[lo].name, name) == 0) {
+            return table[lo].value;
+          }
+        }
+        return nullptr;
+      }
+
+      template<class T, class Map>
+      static void fillTable(ImVector<Entry<T> >& table, const Map& src) {
+        table.clear();
+        table.reserve((int)src.size());
+        for(typename Map::const_iterator iter = src.begin(); iter != src.end(); ++iter) {
+          Entry<T> entry = {ImHashStr(iter->first), iter->first, iter->second};
+          table.push_back(entry);
+        }
+        std::sort(table.begin(), table.end());
+      }
+
+      /**
+       * Freeze attributes and handlers into the hash sorted tables
+       */
+      void finalize() {
+        fillTable(mAttributeTable, mAttributes);
+        fillTable(mHandlerTable, mHandlers);
+        mFinalized = true;
+      }
+
       void merge(ElementBuilder& other) {
         if(other.mTag == mTag) {
           return;
@@ -1105,6 +1435,11 @@ namespace ImVue {
       typedef std::map<const char*, HandlerFactory*, CmpChar> Handlers;
       Handlers mHandlers;
 
+      ImVector<Entry<Attribute> > mAttributeTable;
+      ImVector<Entry<HandlerFactory> > mHandlerTable;
+      bool mFinalized;
+      unsigned int mGeneration;
+
       typedef std::vector<ImString> Inheritance;
       Inheritance mInheritance;
 
@@ -1118,7 +1453,7 @@ namespace ImVue {
   class ElementBuilderImpl : public ElementBuilder {
     public:
       Element* create(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0) const {
-        C* res = new C();
+        C* res = new (ctx->pool) C();
         try {
           res->configure(node, ctx, sctx, parent);
         } catch (...) {
@@ -1190,11 +1525,13 @@ namespace ImVue {
       template<class H>
       ElementBuilderImpl<C>& handler(const char* name)
       {
-        if(mHandlers.count(name) != 0) {
+        if(mHandlers.count(name) != 0 && mHandlers[name]->owner == this) {
           delete mHandlers[name];
         }
         mHandlers[name] = new HandlerFactoryImpl<H>();
         mHandlers[name]->owner = this;
+        mFinalized = false;
+        mGeneration++;
         return *this;
       }
 
@@ -1213,12 +1550,15 @@ namespace ImVue {
 
       void registerAttribute(const char* id, Attribute* attr)
       {
-        if(mAttributes.find(id) != mAttributes.end()) {
+        // inherited attributes are owned by the base builder
+        if(mAttributes.find(id) != mAttributes.end() && mAttributes[id]->owner == this) {
           delete mAttributes[id];
         }
 
         mAttributes[id] = attr;
         attr->owner = this;
+        mFinalized = false;
+        mGeneration++;
         if(attr->required) {
           mRequiredAttrs.push_back(id);
         }
@@ -1278,6 +1618,16 @@ namespace ImVue {
        *
        * @param tagName element tag name
        */
+      /**
+       * Check if the element kind is declared
+       *
+       * @param tagName Associated tag name
+       */
+      inline bool has(const char* tagName) const
+      {
+        return mElementBuilders.find(tagName) != mElementBuilders.end();
+      }
+
       inline ElementBuilder* get(const char* tagName)
       {
         if(mDirty) {
@@ -1319,6 +1669,16 @@ namespace ImVue {
 
       virtual bool check() = 0;
 
+      /**
+       * Mouse handlers are triggered with the hover state computed by the element render instead of check
+       *
+       * @param hovered element is under the cursor
+       * @param changed hover state is different from the previous frame
+       */
+      virtual bool trigger(bool hovered, bool changed) { (void)hovered; (void)changed; return false; }
+
+      virtual bool isMouseHandler() const { return false; }
+
       void parseProperties();
 
       inline bool checkProp(const char* prop) { return mProperties.count(ImHashStr(prop)) != 0; }
@@ -1393,6 +1753,10 @@ namespace ImVue {
       };
 
       MouseEventHandler(Element* element, const char* handlerName, const char* script);
+
+      bool trigger(bool hovered, bool changed);
+
+      bool isMouseHandler() const { return true; }
     protected:
       bool check();
     private:
@@ -1522,8 +1886,16 @@ namespace ImVue {
 
       virtual void removeChildren();
 
+      /**
+       * Create children from the template nodes
+       * Existing children are reused if they were created from the same node and have the same key
+       *
+       * @param doc template root, element node is used by default
+       */
       void createChildren(rapidxml::xml_node<>* doc = 0);
 
+      bool keyMatches(Element* element, rapidxml::xml_node<>* node);
+
       void renderChildren();
 
       Layout mLayout;
@@ -1547,10 +1919,62 @@ namespace ImVue {
    */
   class ElementGroup : public PseudoElement {
     public:
+      ElementGroup();
+      virtual ~ElementGroup();
+
       bool build();
+
+      void splice(const ScriptState::Splice& splice);
+    protected:
+      bool patch();
+
+      void renderBody();
     private:
       typedef std::unordered_map<ScriptState::FieldHash, Element*> ElementsMap;
+      typedef std::unordered_map<int, Element*> RowsMap;
+
+      Element* createRow(Object key, Object value);
+
+      /**
+       * Virtual mode: rows are instantiated only when they get into the viewport
+       */
+      bool buildVirtual(Object& list, ScriptState::Fields& fields);
+
+      void renderVirtual();
+
+      /**
+       * Point recycled row to the list item
+       */
+      void assignRow(Element* row, int index);
+
+      void reindex(size_t from);
+
+      /**
+       * Swap in the new row order, destroy rows which were not matched
+       * and restyle rows whose position can affect sibling selectors
+       */
+      void replaceRows(Elements& rows, ElementsMap& rowsByKey);
+
+      void unsubscribe();
+
       ElementsMap mElementsByKey;
+      ImVector<char*> mIterator;
+      std::vector<ScriptState::Splice> mSplices;
+      Object mList;
+      ScriptState::FieldHash mListHash;
+      ScriptState::FieldHash mListPath;
+      unsigned int mRowCounter;
+      int mValueIndex;
+      int mKeyIndex;
+      bool mSubscribed;
+
+      // virtual mode state
+      RowsMap mRows;
+      Elements mPool;
+      size_t mCount;
+      float mItemHeight;
+      int mOverscan;
+      bool mVirtual;
   };
 
   /**
@@ -1574,7 +1998,7 @@ namespace ImVue {
    */
   class Slot : public PseudoElement {
     public:
-      void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
+      virtual void configure(rapidxml::xml_node<>* node, Context* ctx, ScriptState::Context* sctx = 0, Element* parent = 0);
   };
 
   /**
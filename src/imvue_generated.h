@@ -2160,7 +2160,8 @@ namespace ImVue {
         .attribute("id", &Element::id)
         .attribute("key", &Element::key)
         .attribute("ref", &Element::ref)
-        .setter("style", &Element::setInlineStyle);
+        .setter("style", &Element::setInlineStyle)
+        .setter("cache", &Element::setCache);
 
     factory.element<Slot>("slot");
     return res;
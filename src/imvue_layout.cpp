@@ -123,6 +123,27 @@ namespace ImVue {
     bottomMargin = 0.0f;
   }
 
+  float Layout::nextLineY() const
+  {
+    if(!currentElement) {
+      return ImGui::GetCursorPosY();
+    }
+
+    return lineEnd.y + height + topMargin + bottomMargin;
+  }
+
+  void Layout::moveTo(float y)
+  {
+    if(!currentElement) {
+      cursorStart = ImGui::GetCursorPos();
+    } else {
+      newLine();
+    }
+
+    lineEnd = ImVec2(cursorStart.x, y);
+    ImGui::SetCursorPos(lineEnd);
+  }
+
   void Layout::begin(ContainerElement* element)
   {
     container = element;
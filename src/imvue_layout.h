@@ -63,6 +63,19 @@ namespace ImVue {
 
     void newLine();
 
+    /**
+     * Get vertical position of the next line
+     */
+    float nextLineY() const;
+
+    /**
+     * Wrap line and move it to the vertical position
+     * Used to reserve space for the content which is not rendered
+     *
+     * @param y position in window coordinates
+     */
+    void moveTo(float y);
+
     void endLine();
 
     void begin(ContainerElement* container);
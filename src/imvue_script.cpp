@@ -22,6 +22,7 @@ SOFTWARE.
 
 
 #include <algorithm>
+#include <chrono>
 
 #include "imvue_script.h"
 #include "imvue_element.h"
@@ -30,14 +31,157 @@ namespace ImVue {
 
   Object::Object()
     : mObject(nullptr)
+    , mType(ObjectType::UNKNOWN)
+    , mHeapString(false)
+    , mStrLen(0)
   {
   }
 
   Object::Object(ObjectImpl* oi)
     : mObject(oi)
+    , mType(ObjectType::UNKNOWN)
+    , mHeapString(false)
+    , mStrLen(0)
   {
   }
 
+  Object::Object(const Object& other)
+    : mObject(other.mObject)
+    , mType(other.mType)
+    , mHeapString(false)
+    , mStrLen(0)
+  {
+    if(other.mHeapString) {
+      setInlineString(other.mValue.heapStr, other.mStrLen);
+    } else {
+      mValue = other.mValue;
+      mStrLen = other.mStrLen;
+    }
+  }
+
+  Object::~Object()
+  {
+    reset();
+  }
+
+  Object& Object::operator=(const Object& other)
+  {
+    if(this == &other) {
+      return *this;
+    }
+
+    reset();
+    mObject = other.mObject;
+    mType = other.mType;
+    if(other.mHeapString) {
+      setInlineString(other.mValue.heapStr, other.mStrLen);
+    } else {
+      mValue = other.mValue;
+      mStrLen = other.mStrLen;
+    }
+    return *this;
+  }
+
+  Object Object::nil()
+  {
+    Object res;
+    res.mType = ObjectType::NIL;
+    return res;
+  }
+
+  Object Object::fromBool(bool value)
+  {
+    Object res;
+    res.mType = ObjectType::BOOLEAN;
+    res.mValue.boolean = value;
+    return res;
+  }
+
+  Object Object::fromInteger(long value)
+  {
+    Object res;
+    res.mType = ObjectType::INTEGER;
+    res.mValue.integer = value;
+    return res;
+  }
+
+  Object Object::fromNumber(double value)
+  {
+    Object res;
+    res.mType = ObjectType::NUMBER;
+    res.mValue.number = value;
+    return res;
+  }
+
+  Object Object::fromString(const char* value, size_t len)
+  {
+    Object res;
+    res.mType = ObjectType::STRING;
+    res.setInlineString(value, len);
+    return res;
+  }
+
+  void Object::reset()
+  {
+    if(mHeapString) {
+      ImGui::MemFree(mValue.heapStr);
+      mHeapString = false;
+    }
+    mStrLen = 0;
+    mObject = nullptr;
+    mType = ObjectType::UNKNOWN;
+  }
+
+  void Object::setInlineString(const char* value, size_t len)
+  {
+    char* dest = mValue.str;
+    if(len >= SHORT_STRING_SIZE) {
+      dest = (char*)ImGui::MemAlloc(len + 1);
+      mValue.heapStr = dest;
+      mHeapString = true;
+    }
+    memcpy(dest, value, len);
+    dest[len] = '\0';
+    mStrLen = len;
+  }
+
+  const char* Object::inlineString() const
+  {
+    if(mObject || mType != ObjectType::STRING) {
+      return NULL;
+    }
+
+    return mHeapString ? mValue.heapStr : mValue.str;
+  }
+
+  long Object::readInlineInt() const
+  {
+    switch(mType) {
+      case ObjectType::INTEGER:
+        return mValue.integer;
+      case ObjectType::NUMBER:
+        return (long)mValue.number;
+      case ObjectType::STRING:
+        return (long)strtod(inlineString(), NULL);
+      default:
+        return 0;
+    }
+  }
+
+  double Object::readInlineDouble() const
+  {
+    switch(mType) {
+      case ObjectType::INTEGER:
+        return (double)mValue.integer;
+      case ObjectType::NUMBER:
+        return mValue.number;
+      case ObjectType::STRING:
+        return strtod(inlineString(), NULL);
+      default:
+        return 0.0;
+    }
+  }
+
   Object::iterator Object::begin()
   {
     return Object::iterator(*this);
@@ -50,26 +194,42 @@ namespace ImVue {
 
   Object Object::operator[](const Object& key)
   {
+    if(!mObject) {
+      IMVUE_EXCEPTION(ScriptError, "failed to get key: not an object");
+      return Object();
+    }
     return mObject->get(key);
   }
 
   Object Object::operator[](const char* key)
   {
+    if(!mObject) {
+      IMVUE_EXCEPTION(ScriptError, "failed to get key %s: not an object", key);
+      return Object();
+    }
     return mObject->get(key);
   }
 
   Object Object::operator[](int index)
   {
+    if(!mObject) {
+      IMVUE_EXCEPTION(ScriptError, "failed to get index %d: not an object", index);
+      return Object();
+    }
     return mObject->get(index);
   }
 
   void Object::erase(const Object& key)
   {
+    if(!mObject) {
+      IMVUE_EXCEPTION(ScriptError, "failed to erase key: not an object");
+      return;
+    }
     mObject->erase(key);
   }
 
   bool Object::valid() const {
-    return mObject != 0;
+    return mObject != 0 || mType != ObjectType::UNKNOWN;
   }
 
   Object::operator bool() const
@@ -88,21 +248,68 @@ namespace ImVue {
   }
 
   ObjectType Object::type() const {
-    return !mObject ? ObjectType::NIL : mObject->type();
+    if(mObject) {
+      return mObject->type();
+    }
+
+    return mType == ObjectType::UNKNOWN ? ObjectType::NIL : mType;
   }
 
   void Object::keys(ObjectKeys& dest) {
+    if(!mObject) {
+      return;
+    }
     return mObject->keys(dest);
   }
 
+  bool Object::next(Object& key, Object& value, int& cursor) {
+    if(!mObject) {
+      return false;
+    }
+    return mObject->next(key, value, cursor);
+  }
+
+  size_t Object::size() {
+    if(!mObject) {
+      return 0;
+    }
+    return mObject->size();
+  }
+
   bool Object::setValue(void* value, ObjectType type)
   {
+    if(!mObject && type != ObjectType::OBJECT && type != ObjectType::VEC2) {
+      // object does not reference script state: keep the value inline
+      reset();
+      switch(type) {
+        case ObjectType::INTEGER:
+          mValue.integer = *reinterpret_cast<long*>(value);
+          break;
+        case ObjectType::NUMBER:
+          mValue.number = *reinterpret_cast<double*>(value);
+          break;
+        case ObjectType::STRING:
+          {
+            const char* str = *reinterpret_cast<const char**>(value);
+            setInlineString(str, strlen(str));
+          }
+          break;
+        case ObjectType::BOOLEAN:
+          mValue.boolean = *reinterpret_cast<bool*>(value);
+          break;
+        default:
+          return false;
+      }
+      mType = type;
+      return true;
+    }
+
     switch(type) {
       case ObjectType::OBJECT:
         if(mObject) {
           mObject->setObject(*reinterpret_cast<Object*>(value));
         } else {
-          mObject = reinterpret_cast<Object*>(value)->mObject;
+          *this = *reinterpret_cast<Object*>(value);
         }
         break;
       case ObjectType::INTEGER:
@@ -118,6 +325,10 @@ namespace ImVue {
         mObject->setBool(*reinterpret_cast<bool*>(value));
         break;
       case ObjectType::VEC2:
+        if(!mObject) {
+          IMVUE_EXCEPTION(ScriptError, "failed to set vec2: not an object");
+          return false;
+        }
         mObject->initObject();
         (*this)["x"] = (*reinterpret_cast<ImVec2*>(value)).x;
         (*this)["y"] = (*reinterpret_cast<ImVec2*>(value)).y;
@@ -132,7 +343,7 @@ namespace ImVue {
   double Object::as<double>() const
   {
     if(!mObject) {
-      return 0.0;
+      return readInlineDouble();
     }
 
     return mObject->readDouble();
@@ -143,6 +354,26 @@ namespace ImVue {
   {
     ImString str;
     if(!mObject) {
+      char buf[64];
+      switch(mType) {
+        case ObjectType::STRING:
+          str = inlineString();
+          break;
+        case ObjectType::INTEGER:
+          ImFormatString(buf, sizeof(buf), "%ld", mValue.integer);
+          str = buf;
+          break;
+        case ObjectType::NUMBER:
+          if(mValue.number == (double)(long)mValue.number) {
+            ImFormatString(buf, sizeof(buf), "%ld", (long)mValue.number);
+          } else {
+            ImFormatString(buf, sizeof(buf), "%.14g", mValue.number);
+          }
+          str = buf;
+          break;
+        default:
+          break;
+      }
       return str;
     }
 
@@ -154,7 +385,15 @@ namespace ImVue {
   bool Object::as<bool>() const
   {
     if(!mObject) {
-      return false;
+      switch(mType) {
+        case ObjectType::UNKNOWN:
+        case ObjectType::NIL:
+          return false;
+        case ObjectType::BOOLEAN:
+          return mValue.boolean;
+        default:
+          return true;
+      }
     }
 
     return mObject->readBool();
@@ -166,10 +405,18 @@ namespace ImVue {
     return (float)as<double>();
   }
 
-  void ScriptState::ReactListener::trigger()
+  void ScriptState::Subscription::trigger()
   {
-    if(propertyID.get()) {
-      element->invalidate(propertyID.get());
+    if(observer) {
+      // synchronous observers were notified when the change was pushed
+      if(!observer->synchronous()) {
+        observer->notify(field);
+      }
+      return;
+    }
+
+    if(slot >= 0) {
+      element->invalidateSlot(slot);
     }
 
     if(flags) {
@@ -254,34 +501,298 @@ namespace ImVue {
     return true;
   }
 
-  void ScriptState::addListener(ScriptState::FieldHash id, Element* element, const char* attribute, unsigned int flags)
+  ScriptState::Listeners::Listeners()
+    : mSlots(NULL)
+    , mCapacity(0)
+    , mUsed(0)
+  {
+  }
+
+  ScriptState::Listeners::~Listeners()
+  {
+    if(mSlots) {
+      ImGui::MemFree(mSlots);
+    }
+  }
+
+  int ScriptState::Listeners::lookup(FieldHash field) const
+  {
+    if(mCapacity == 0) {
+      return -1;
+    }
+
+    int mask = mCapacity - 1;
+    for(int i = (int)(field & mask);; i = (i + 1) & mask) {
+      const Slot& slot = mSlots[i];
+      if(!slot.used || slot.field == field) {
+        return i;
+      }
+    }
+  }
+
+  ScriptState::Subscription* ScriptState::Listeners::find(FieldHash field) const
   {
-    if(mListeners.count(id) == 0) {
-      mListeners[id] = ListenerList();
+    int index = lookup(field);
+    if(index == -1 || !mSlots[index].used) {
+      return NULL;
     }
 
-    ReactListener listener{
-      element,
-      ImString(attribute),
-      flags
-    };
-    mListeners[id].push_back(listener);
+    return mSlots[index].head;
+  }
+
+  ScriptState::Subscription*& ScriptState::Listeners::get(FieldHash field)
+  {
+    int index = lookup(field);
+    if(index != -1 && mSlots[index].used) {
+      return mSlots[index].head;
+    }
+
+    // keep load factor under 0.75
+    if((mUsed + 1) * 4 > mCapacity * 3) {
+      rehash();
+      index = lookup(field);
+    }
+
+    Slot& slot = mSlots[index];
+    if(!slot.used) {
+      slot.used = true;
+      slot.field = field;
+      slot.head = NULL;
+      mUsed++;
+    }
+    return slot.head;
+  }
+
+  void ScriptState::Listeners::rehash()
+  {
+    // fields without listeners are dropped
+    int live = 0;
+    for(int i = 0; i < mCapacity; ++i) {
+      if(mSlots[i].used && mSlots[i].head) {
+        live++;
+      }
+    }
+
+    int capacity = 64;
+    while(capacity < (live + 1) * 2) {
+      capacity *= 2;
+    }
+
+    Slot* slots = mSlots;
+    int count = mCapacity;
+
+    mSlots = (Slot*)ImGui::MemAlloc(sizeof(Slot) * capacity);
+    memset(mSlots, 0, sizeof(Slot) * capacity);
+    mCapacity = capacity;
+    mUsed = 0;
+
+    for(int i = 0; i < count; ++i) {
+      if(slots[i].used && slots[i].head) {
+        Slot& slot = mSlots[lookup(slots[i].field)];
+        slot = slots[i];
+        mUsed++;
+      }
+    }
+
+    if(slots) {
+      ImGui::MemFree(slots);
+    }
+  }
+
+  ScriptState::SubscriptionPool::~SubscriptionPool()
+  {
+    for(int i = 0; i < mBlocks.size(); ++i) {
+      ImGui::MemFree(mBlocks[i]);
+    }
+  }
+
+  ScriptState::Subscription* ScriptState::SubscriptionPool::alloc()
+  {
+    if(!mFree) {
+      Subscription* block = (Subscription*)ImGui::MemAlloc(sizeof(Subscription) * BLOCK_SIZE);
+      mBlocks.push_back(block);
+      for(int i = BLOCK_SIZE - 1; i >= 0; --i) {
+        block[i].next = mFree;
+        mFree = &block[i];
+      }
+    }
+
+    Subscription* subscription = mFree;
+    mFree = subscription->next;
+    return subscription;
+  }
+
+  void ScriptState::SubscriptionPool::free(Subscription* subscription)
+  {
+    subscription->next = mFree;
+    mFree = subscription;
+  }
+
+  ScriptState::~ScriptState()
+  {
+  }
+
+  void ScriptState::addListener(ScriptState::FieldHash id, Element* element, int slot, unsigned int flags)
+  {
+    subscribe(id, element->mSubscriptions, element, NULL, slot, flags);
+  }
+
+  void ScriptState::addObserver(ScriptState::FieldHash id, Observer* observer)
+  {
+    subscribe(id, observer->mSubscriptions, NULL, observer, -1, 0);
+  }
+
+  void ScriptState::subscribe(ScriptState::FieldHash id, Subscription*& owned, Element* element, Observer* observer, int slot, unsigned int flags)
+  {
+    for(Subscription* s = owned; s; s = s->nextOwned) {
+      if(s->field == id && s->slot == slot) {
+        s->flags |= flags;
+        return;
+      }
+    }
+
+    Subscription* subscription = mSubscriptionPool.alloc();
+    subscription->field = id;
+    subscription->element = element;
+    subscription->observer = observer;
+    subscription->slot = slot;
+    subscription->flags = flags;
+
+    Subscription*& head = mListeners.get(id);
+    subscription->prev = NULL;
+    subscription->next = head;
+    if(head) {
+      head->prev = subscription;
+    }
+    head = subscription;
+
+    subscription->nextOwned = owned;
+    owned = subscription;
+
+    if(observer && observer->synchronous()) {
+      mSynchronousCount++;
+    }
+  }
+
+  void ScriptState::unsubscribe(Subscription*& owned)
+  {
+    Subscription* s = owned;
+    while(s) {
+      Subscription* next = s->nextOwned;
+      unlink(s);
+      s = next;
+    }
+    owned = NULL;
+  }
+
+  void ScriptState::unlink(Subscription* subscription)
+  {
+    if(subscription->prev) {
+      subscription->prev->next = subscription->next;
+    } else {
+      mListeners.get(subscription->field) = subscription->next;
+    }
+
+    if(subscription->next) {
+      subscription->next->prev = subscription->prev;
+    }
+
+    if(subscription->observer && subscription->observer->synchronous()) {
+      mSynchronousCount--;
+    }
+
+    mSubscriptionPool.free(subscription);
   }
 
   bool ScriptState::removeListener(ScriptState::FieldHash field, Element* element)
   {
-    if(mListeners.count(field) == 0) {
-      return false;
+    bool removed = false;
+    Subscription** link = &element->mSubscriptions;
+    while(*link) {
+      Subscription* s = *link;
+      if(s->field == field) {
+        *link = s->nextOwned;
+        unlink(s);
+        removed = true;
+      } else {
+        link = &s->nextOwned;
+      }
     }
+    return removed;
+  }
 
-    ListenerList& listeners = mListeners[field];
-    if(listeners.size() == 1) {
-      mListeners.erase(field);
-      return true;
+  void ScriptState::removeListeners(Element* element)
+  {
+    unsubscribe(element->mSubscriptions);
+  }
+
+  void ScriptState::removeObserver(Observer* observer)
+  {
+    unsubscribe(observer->mSubscriptions);
+  }
+
+  void ScriptState::Watcher::notify(FieldHash field)
+  {
+    (void)field;
+    if(!mQueued) {
+      mQueued = true;
+      mScriptState->mWatchQueue.push_back(this);
     }
+  }
 
-    listeners.erase(std::remove(listeners.begin(), listeners.end(), element), listeners.end());
-    return true;
+  void ScriptState::addWatcher(ScriptState::FieldHash id, Watcher* watcher, bool deep)
+  {
+    addObserver(id, watcher);
+    if(deep) {
+      addObserver(deepHash(id), watcher);
+    }
+  }
+
+  void ScriptState::removeWatcher(Watcher* watcher)
+  {
+    removeObserver(watcher);
+    if(watcher->mQueued) {
+      Watcher** iter = mWatchQueue.find(watcher);
+      if(iter != mWatchQueue.end()) {
+        mWatchQueue.erase(iter);
+      }
+      watcher->mQueued = false;
+    }
+  }
+
+  void ScriptState::flushWatchers()
+  {
+    if(mWatchQueue.size() == 0) {
+      return;
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    ImVector<Watcher*> queue;
+    queue.swap(mWatchQueue);
+
+    int i = 0;
+    while(i < queue.size()) {
+      Watcher* watcher = queue[i++];
+      watcher->mQueued = false;
+      watcher->run();
+
+      if(mWatchBudget > 0 && std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= mWatchBudget) {
+        break;
+      }
+    }
+
+    // postponed watchers go before the ones queued during the flush
+    ImVector<Watcher*> queued;
+    queued.swap(mWatchQueue);
+    for(; i < queue.size(); ++i) {
+      mWatchQueue.push_back(queue[i]);
+    }
+
+    for(int j = 0; j < queued.size(); ++j) {
+      mWatchQueue.push_back(queued[j]);
+    }
   }
 
   void ScriptState::pushChange(const char* field) {
@@ -289,17 +800,130 @@ namespace ImVue {
   }
 
   void ScriptState::pushChange(ScriptState::FieldHash h) {
-    mChangedStack.push_back(h);
+    if(mDirtySet.insert(h).second) {
+      mDirtyFields.push_back(h);
+    }
+    notifySynchronous(h);
+  }
+
+  void ScriptState::notifySynchronous(ScriptState::FieldHash h)
+  {
+    if(mSynchronousCount == 0) {
+      return;
+    }
+
+    for(Subscription* s = mListeners.find(h); s; s = s->next) {
+      if(s->observer && s->observer->synchronous()) {
+        s->observer->notify(h);
+      }
+    }
   }
 
-  void ScriptState::changed(ScriptState::FieldHash id)
+  void ScriptState::addSpliceListener(ScriptState::FieldHash list, Element* element)
   {
-    if(mListeners.count(id) > 0) {
+    mSpliceListeners[list].push_back(element);
+  }
+
+  void ScriptState::removeSpliceListener(ScriptState::FieldHash list, Element* element)
+  {
+    SpliceListeners::iterator iter = mSpliceListeners.find(list);
+    if(iter == mSpliceListeners.end()) {
+      return;
+    }
+
+    SpliceListenerList& listeners = iter->second;
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), element), listeners.end());
+    if(listeners.empty()) {
+      mSpliceListeners.erase(iter);
+    }
+  }
+
+  bool ScriptState::pushSplice(ScriptState::FieldHash list, Splice::Type type, int index, Object value)
+  {
+    if(!hasSpliceListeners(list)) {
+      return false;
+    }
+
+    SpliceEvent event;
+    event.list = list;
+    event.splice.type = type;
+    event.splice.index = index;
+    event.splice.value = value;
+    mSplices.push_back(event);
+    notifySynchronous(list);
+    notifySynchronous(deepHash(list));
+    return true;
+  }
+
+  void ScriptState::dispatchSplices()
+  {
+    std::vector<SpliceEvent> events;
+    events.swap(mSplices);
+
+    for(size_t i = 0; i < events.size(); ++i) {
+      SpliceEvent& event = events[i];
+      SpliceListeners::iterator iter = mSpliceListeners.find(event.list);
+      if(iter == mSpliceListeners.end()) {
+        // splice listener was destroyed after the event was queued
+        changed(event.list);
+        changed(deepHash(event.list));
+        continue;
+      }
+
+      SpliceListenerList& listeners = iter->second;
+      for(size_t j = 0; j < listeners.size(); ++j) {
+        listeners[j]->splice(event.splice);
+      }
+
+      changed(event.list, &listeners);
+      changed(deepHash(event.list), &listeners);
+    }
+  }
+
+  void ScriptState::flushChanges()
+  {
+    mUpdateNotified = false;
+
+    if(mSplices.size() > 0) {
+      dispatchSplices();
+    }
+
+    // fields changed by the listeners are appended and processed in the same flush,
+    // a field processed already is queued again if it is changed once more
+    for(int i = 0; i < mDirtyFields.size(); ++i) {
+      ScriptState::FieldHash h = mDirtyFields[i];
+      mDirtySet.erase(h);
+      changed(h);
+    }
+
+    mDirtyFields.clear();
+    mDirtySet.clear();
+  }
+
+  void ScriptState::triggerListeners(ScriptState::FieldHash h)
+  {
+    for(Subscription* s = mListeners.find(h); s; s = s->next) {
+      s->trigger();
+    }
+  }
+
+  void ScriptState::changed(ScriptState::FieldHash id, const SpliceListenerList* exclude)
+  {
+    if(!mListeners.find(id)) {
+      return;
+    }
+
+    if(!mUpdateNotified) {
+      mUpdateNotified = true;
       lifecycleCallback(LifecycleCallbackType::BEFORE_UPDATE);
-      ListenerList listeners = mListeners[id];
-      for(ListenerList::iterator iter = listeners.begin(); iter != listeners.end(); ++iter) {
-        iter->trigger();
+    }
+
+    // triggering only invalidates elements, so the list is not modified while iterating
+    for(Subscription* s = mListeners.find(id); s; s = s->next) {
+      if(exclude && std::find(exclude->begin(), exclude->end(), s->element) != exclude->end()) {
+        continue;
       }
+      s->trigger();
     }
   }
 
@@ -26,6 +26,7 @@ SOFTWARE.
 #include <string>
 #include <iostream>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
 
@@ -131,6 +132,23 @@ namespace ImVue {
        */
       virtual void keys(ObjectKeys& dest) = 0;
 
+      /**
+       * Advance iteration without materializing the key list,
+       * the object must not be modified until iteration is over
+       *
+       * @param key previous key on input, next key on output
+       * @param value next value
+       * @param cursor sequential part position, 0 on the first call
+       *
+       * @returns false when there are no more pairs
+       */
+      virtual bool next(Object& key, Object& value, int& cursor) = 0;
+
+      /**
+       * Get length of the sequential part
+       */
+      virtual size_t size() = 0;
+
       /**
        * Read value as integer
        */
@@ -174,6 +192,26 @@ namespace ImVue {
 
       Object(ObjectImpl* oi);
 
+      Object(const Object& other);
+
+      ~Object();
+
+      Object& operator=(const Object& other);
+
+      /**
+       * Inline scalar constructors: these values are stored in the object
+       * itself and never touch the heap or the script state
+       */
+      static Object nil();
+
+      static Object fromBool(bool value);
+
+      static Object fromInteger(long value);
+
+      static Object fromNumber(double value);
+
+      static Object fromString(const char* value, size_t len);
+
       iterator begin();
 
       iterator end();
@@ -196,10 +234,29 @@ namespace ImVue {
 
       void keys(ObjectKeys& dest);
 
+      bool next(Object& key, Object& value, int& cursor);
+
+      size_t size();
+
       inline ObjectImpl* getImpl() { return mObject.get(); }
 
       inline const ObjectImpl* getImpl() const { return mObject.get(); }
 
+      /**
+       * Object value is stored inline instead of the script state
+       */
+      inline bool isInline() const { return !mObject && mType != ObjectType::UNKNOWN; }
+
+      /**
+       * Get inline string without copying, NULL if the object is not an inline string
+       */
+      const char* inlineString() const;
+
+      /**
+       * Get inline string length, inline strings may contain embedded zeros
+       */
+      inline size_t inlineStringLength() const { return mStrLen; }
+
       template<class C>
       typename std::enable_if<std::is_integral<C>::value, bool>::type set(C* value, ObjectType type)
       {
@@ -229,7 +286,7 @@ namespace ImVue {
       C as(std::true_type) const
       {
         if(!mObject) {
-          return 0;
+          return (C)readInlineInt();
         }
 
         return (C)mObject->readInt();
@@ -247,10 +304,33 @@ namespace ImVue {
         set(&value, typeID<C>::value());
         return *this;
       }
+      /**
+       * Strings shorter than this are kept inline
+       */
+      static const size_t SHORT_STRING_SIZE = 24;
+
     private:
       bool setValue(void* value, ObjectType type);
 
+      void setInlineString(const char* value, size_t len);
+
+      long readInlineInt() const;
+
+      double readInlineDouble() const;
+
+      void reset();
+
       std::shared_ptr<ObjectImpl> mObject;
+      ObjectType mType;
+      bool mHeapString;
+      size_t mStrLen;
+      union {
+        bool boolean;
+        long integer;
+        double number;
+        char str[SHORT_STRING_SIZE];
+        char* heapStr;
+      } mValue;
   };
 
   template<>
@@ -269,24 +349,20 @@ namespace ImVue {
     public:
       ObjectIterator(int index = -1)
         : mIndex(index)
+        , mCursor(0)
       {
       }
 
       ObjectIterator(Object src)
         : mIndex(-1)
+        , mCursor(0)
         , mSrc(src)
       {
-        src.keys(mKeys);
         advance();
       }
 
-      ~ObjectIterator()
-      {
-        mKeys.clear();
-      }
-
       bool operator!() {
-        return mIndex < 0 || mIndex > (int)mKeys.size();
+        return mIndex < 0;
       }
 
       bool operator==(const ObjectIterator& iter) const {
@@ -312,17 +388,15 @@ namespace ImVue {
           return;
         }
 
-        mIndex++;
-        if(mIndex >= (int)mKeys.size()) {
+        if(!mSrc.next(key, value, mCursor)) {
           mIndex = -2;
           return;
         }
-        key = mKeys[mIndex];
-        value = mSrc[key];
+        mIndex++;
       }
 
       int mIndex;
-      ObjectKeys mKeys;
+      int mCursor;
       Object mSrc;
   };
 
@@ -373,9 +447,18 @@ namespace ImVue {
        * Context is evaluation environment
        */
       struct Context {
+        /**
+         * Script implementation specific evaluation environment cache
+         */
+        struct Environment {
+          virtual ~Environment() {}
+        };
+
         Context(ScriptState::FieldHash h, Context* parent = 0)
           : hash(h)
           , owner(NULL)
+          , env(NULL)
+          , version(0)
           , mOffset(0)
         {
           if(parent) {
@@ -386,6 +469,10 @@ namespace ImVue {
 
         ~Context()
         {
+          if(env) {
+            delete env;
+          }
+
           while(vars.size() > mOffset)
           {
             ImGui::MemFree(vars[vars.size() - 1].key);
@@ -396,11 +483,27 @@ namespace ImVue {
         void add(char* key, Object value, Variable::Type type)
         {
           vars.push_back(Variable{ImStrdup(key), value, type});
+          version++;
+        }
+
+        /**
+         * Update variable value
+         *
+         * @param index variable index
+         * @param value new value
+         */
+        void set(size_t index, Object value)
+        {
+          vars[index].value = value;
+          version++;
         }
 
         std::vector<Variable> vars;
         ScriptState::FieldHash hash;
         Element* owner;
+        Environment* env;
+        // incremented on each variables change
+        unsigned int version;
 
         private:
           Context(Context& other) {
@@ -411,18 +514,91 @@ namespace ImVue {
           size_t mOffset;
       };
 
-      struct ReactListener {
+      struct Subscription;
+
+      /**
+       * Field changes listener which is not an element
+       */
+      class Observer {
+        public:
+          /**
+           * @param synchronous notify from pushChange, so the observer never sees stale values
+           */
+          Observer(bool synchronous = false) : mSubscriptions(NULL), mSynchronous(synchronous) {}
+          virtual ~Observer() {}
+
+          /**
+           * Called when a field the observer is subscribed to is changed
+           */
+          virtual void notify(FieldHash field) = 0;
+
+          inline bool synchronous() const { return mSynchronous; }
+        private:
+          friend class ScriptState;
+
+          Subscription* mSubscriptions;
+          bool mSynchronous;
+      };
+
+      /**
+       * Deferred field changes callback
+       * Notified watchers are queued once and run by flushWatchers
+       */
+      class Watcher : public Observer {
+        public:
+          Watcher(ScriptState* state) : mScriptState(state), mQueued(false) {}
+          virtual ~Watcher() {}
+
+          void notify(FieldHash field);
+
+          /**
+           * Run watcher callback
+           */
+          virtual void run() = 0;
+        private:
+          friend class ScriptState;
+
+          ScriptState* mScriptState;
+          bool mQueued;
+      };
+
+      /**
+       * Element or observer subscription to the field changes
+       *
+       * Nodes are pooled by the script state and linked into two lists:
+       * the field listeners list and the owner subscriptions list
+       */
+      struct Subscription {
+        FieldHash field;
         Element* element;
-        ImString propertyID;
+        Observer* observer;
+        // element attribute slot to invalidate, -1 if none
+        int slot;
         unsigned int flags;
-
-        bool operator==(const Element* e) {
-          return element == e;
-        }
+        Subscription* prev;
+        Subscription* next;
+        Subscription* nextOwned;
 
         void trigger();
       };
 
+      /**
+       * Structural change of an array
+       */
+      struct Splice {
+        enum Type {
+          INSERT,
+          REMOVE,
+          SET
+        };
+
+        Type type;
+        // zero based item index
+        int index;
+        // new item value, empty for REMOVE
+        Object value;
+      };
+
       enum LifecycleCallbackType {
         BEFORE_CREATE = 1 << 0,
         CREATED = 1 << 1,
@@ -434,9 +610,9 @@ namespace ImVue {
         DESTROYED = 1 << 7
       };
 
-      ScriptState() : mLifecycleDirty(0) {}
+      ScriptState() : mSynchronousCount(0), mLifecycleDirty(0), mUpdateNotified(false), mWatchBudget(0) {}
 
-      virtual ~ScriptState() {}
+      virtual ~ScriptState();
 
       /**
        * Get or create object from state object
@@ -471,6 +647,34 @@ namespace ImVue {
        */
       virtual Object getObject(const char* str, Fields* fields = 0, ScriptState::Context* ctx = 0) = 0;
 
+      /**
+       * Compiles a list of expressions into a single evaluation unit
+       *
+       * @param expressions expressions list
+       * @returns batch id, 0 if batching is not supported
+       */
+      virtual int compileBatch(const ImVector<const char*>& expressions) { (void)expressions; return 0; }
+
+      /**
+       * Evaluates all batch expressions in a single call
+       * getObject calls for the batch expressions return precomputed results until endBatch is called
+       *
+       * @param batch batch id
+       * @param ctx script evaluation context
+       * @returns false if batch evaluation failed
+       */
+      virtual bool beginBatch(int batch, ScriptState::Context* ctx = 0) { (void)batch; (void)ctx; return false; }
+
+      /**
+       * Drop precomputed batch results
+       */
+      virtual void endBatch() {}
+
+      /**
+       * Release compiled batch
+       */
+      virtual void releaseBatch(int batch) { (void)batch; }
+
       /**
        * Parses iterator definition
        */
@@ -480,8 +684,99 @@ namespace ImVue {
 
       void pushChange(ScriptState::FieldHash h);
 
+      /**
+       * Invalidate listeners of the field right away instead of waiting for the next flush
+       * Used for the elements which are about to be rendered in the current frame
+       */
+      void triggerListeners(ScriptState::FieldHash h);
+
+      /**
+       * Remove element subscriptions to the field
+       *
+       * @returns false if element was not subscribed to the field
+       */
       bool removeListener(ScriptState::FieldHash id, Element* element);
 
+      /**
+       * Remove all element subscriptions
+       */
+      void removeListeners(Element* element);
+
+      /**
+       * Subscribe observer to the field changes
+       */
+      void addObserver(ScriptState::FieldHash id, Observer* observer);
+
+      /**
+       * Remove all observer subscriptions
+       */
+      void removeObserver(Observer* observer);
+
+      /**
+       * Subscribe watcher to the field changes
+       *
+       * @param id field hash
+       * @param watcher watcher to queue when the field is changed
+       * @param deep also react on nested fields changes
+       */
+      void addWatcher(ScriptState::FieldHash id, Watcher* watcher, bool deep = false);
+
+      /**
+       * Remove watcher subscriptions and drop it from the queue
+       */
+      void removeWatcher(Watcher* watcher);
+
+      /**
+       * Run queued watchers
+       * Watchers that did not fit into the time budget are left for the next flush
+       */
+      void flushWatchers();
+
+      /**
+       * Set watchers flush time budget
+       *
+       * @param ms max time in milliseconds, 0 to run all queued watchers
+       */
+      inline void setWatchBudget(double ms) { mWatchBudget = ms; }
+
+      /**
+       * Subscribe element to the array structural changes
+       * Regular listeners of the array are still notified, but the subscribed element receives splices instead
+       *
+       * @param list array path hash
+       * @param element element to receive splice events
+       */
+      void addSpliceListener(ScriptState::FieldHash list, Element* element);
+
+      void removeSpliceListener(ScriptState::FieldHash list, Element* element);
+
+      inline bool hasSpliceListeners(ScriptState::FieldHash list) const {
+        return mSpliceListeners.count(list) != 0;
+      }
+
+      /**
+       * Queue array splice event
+       *
+       * @param list array path hash
+       * @param type splice type
+       * @param index zero based item index
+       * @param value new item value
+       * @returns false if nobody listens for the array splices
+       */
+      bool pushSplice(ScriptState::FieldHash list, Splice::Type type, int index, Object value = Object());
+
+      /**
+       * Get path hash of the reactive object
+       *
+       * @returns false if object changes can not be tracked by path
+       */
+      virtual bool reactivePath(const Object& object, FieldHash& path) { (void)object; (void)path; return false; }
+
+      /**
+       * Create integer script object
+       */
+      virtual Object createInteger(long value) { (void)value; return Object(); }
+
       /**
        * Register element by reference
        * <element ref="id"/>
@@ -515,31 +810,40 @@ namespace ImVue {
           mLifecycleDirty = 0;
         }
 
-        while(mChangedStack.size() > 0) {
-          changed(mChangedStack[mChangedStack.size() - 1]);
-          mChangedStack.pop_back();
+        if(mSplices.size() > 0 || mDirtyFields.size() > 0) {
+          flushChanges();
         }
       }
 
+      /**
+       * Check if there are changes, splices, watchers or lifecycle callbacks waiting for the next update
+       */
+      inline bool hasPendingChanges() const {
+        return mLifecycleDirty != 0 || mDirtyFields.size() > 0 || mSplices.size() > 0 || mWatchQueue.size() > 0;
+      }
+
       /**
        * Clear changed stack without applying updates
        */
       inline void clearChanges()
       {
-        mChangedStack.clear();
+        mDirtyFields.clear();
+        mDirtySet.clear();
+        mSplices.clear();
       }
 
       virtual void lifecycleCallback(LifecycleCallbackType cb) { (void)cb; }
 
       /**
        * Bind listener for property and field hash
+       * Subscribing the same element attribute to the same field twice has no effect
        *
        * @param id property hash. Script state id
        * @param element element to trigger invalidation when change comes
-       * @param attribute element attribute to invalidate
+       * @param slot element attribute slot to invalidate, -1 if none
        * @param flags state invalidation flags
        */
-      void addListener(ScriptState::FieldHash id, Element* element, const char* attribute, unsigned int flags = 0);
+      void addListener(ScriptState::FieldHash id, Element* element, int slot, unsigned int flags = 0);
 
       /**
        * Create script state clone
@@ -555,23 +859,138 @@ namespace ImVue {
         return ImHashStr(str);
       }
 
+      /**
+       * Convert nested field path to hash
+       *
+       * @param str field name
+       * @param parent parent path hash
+       */
+      inline FieldHash hash(const char* str, FieldHash parent) const {
+        return ImHashStr(str, 0, parent);
+      }
+
+      /**
+       * Get hash that is changed when any nested field of the path is changed
+       */
+      inline FieldHash deepHash(FieldHash h) const {
+        return ImHashStr("*", 0, h);
+      }
+
+      /**
+       * Make listeners of the fields react on nested fields changes too
+       */
+      inline void addDeepFields(Fields& fields) const {
+        int count = fields.size();
+        for(int i = 0; i < count; ++i) {
+          fields.push_back(deepHash(fields[i]));
+        }
+      }
+
     protected:
 
-      void changed(ScriptState::FieldHash hash);
+      typedef std::vector<Element*> SpliceListenerList;
+
+      void changed(ScriptState::FieldHash hash, const SpliceListenerList* exclude = 0);
+
+      /**
+       * Notify listeners of all fields changed since the last flush
+       * Each field is processed once unless it is changed again after being processed,
+       * beforeUpdate is called once per flush
+       */
+      void flushChanges();
+
+      void dispatchSplices();
+
+      /**
+       * Open addressing table of the field listeners lists
+       */
+      class Listeners {
+        public:
+          Listeners();
+          ~Listeners();
+
+          /**
+           * Get listeners list head, NULL if there are no listeners
+           */
+          Subscription* find(FieldHash field) const;
 
-      typedef std::vector<ReactListener> ListenerList;
+          /**
+           * Get listeners list head slot, creates the slot if it does not exist
+           */
+          Subscription*& get(FieldHash field);
 
-      typedef std::unordered_map<ScriptState::FieldHash, ListenerList> Listeners;
+        private:
+          struct Slot {
+            FieldHash field;
+            Subscription* head;
+            bool used;
+          };
+
+          int lookup(FieldHash field) const;
+
+          void rehash();
+
+          Slot* mSlots;
+          int mCapacity;
+          int mUsed;
+      };
+
+      /**
+       * Block allocator for subscriptions
+       */
+      class SubscriptionPool {
+        public:
+          SubscriptionPool() : mFree(NULL) {}
+          ~SubscriptionPool();
+
+          Subscription* alloc();
+
+          void free(Subscription* subscription);
+
+        private:
+          static const int BLOCK_SIZE = 256;
+
+          ImVector<Subscription*> mBlocks;
+          Subscription* mFree;
+      };
+
+      void subscribe(ScriptState::FieldHash id, Subscription*& owned, Element* element, Observer* observer, int slot, unsigned int flags);
+
+      void unsubscribe(Subscription*& owned);
+
+      void unlink(Subscription* subscription);
+
+      /**
+       * Notify synchronous observers of the field right away
+       */
+      void notifySynchronous(ScriptState::FieldHash h);
+
+      typedef std::unordered_map<ScriptState::FieldHash, SpliceListenerList> SpliceListeners;
+
+      struct SpliceEvent {
+        ScriptState::FieldHash list;
+        Splice splice;
+      };
 
       void handleError(const std::string& error) {
         IMVUE_LOG_ERROR(std::string("Script Error: ") + error, __FILE__, __LINE__);
       }
 
       Listeners mListeners;
-      ImVector<ScriptState::FieldHash> mChangedStack;
+      SubscriptionPool mSubscriptionPool;
+      // number of synchronous observers subscriptions
+      int mSynchronousCount;
+      // changed fields in the order of the first change
+      ImVector<ScriptState::FieldHash> mDirtyFields;
+      std::unordered_set<ScriptState::FieldHash> mDirtySet;
+      SpliceListeners mSpliceListeners;
+      std::vector<SpliceEvent> mSplices;
 
       unsigned int mLifecycleDirty;
       RefMap mRefMap;
+      bool mUpdateNotified;
+      ImVector<Watcher*> mWatchQueue;
+      double mWatchBudget;
 
   };
 } // namespace ImVue
@@ -1128,7 +1128,7 @@ namespace ImVue {
     cleanupClassCache();
     for(Element::Classes::iterator iter = element->classes.begin(); iter != element->classes.end(); ++iter) {
       lwc_string* str = 0;
-      if(lwc_intern_string(iter->first, strlen(iter->first), &str) != lwc_error_ok) {
+      if(lwc_intern_string(*iter, strlen(*iter), &str) != lwc_error_ok) {
         continue;
       }
 
@@ -1316,8 +1316,66 @@ namespace ImVue {
   "}";
 
 
+  struct PseudoState {
+    const char* name;
+    int state;
+  };
+
+  // pseudo-classes matched against Element states in css/select.cpp
+  static const PseudoState pseudoStates[] = {
+    {"hover", Element::HOVERED},
+    {"active", Element::ACTIVE},
+    {"focus", Element::FOCUSED},
+    {"checked", Element::CHECKED},
+    {"disabled", Element::DISABLED},
+    {"enabled", Element::DISABLED},
+    {"link", Element::LINK},
+    {"visited", Element::VISITED}
+  };
+
+  static int pseudoState(const char* name, size_t len)
+  {
+    for(int i = 0; i < IM_ARRAYSIZE(pseudoStates); ++i) {
+      if(strlen(pseudoStates[i].name) == len && ImStrnicmp(pseudoStates[i].name, name, len) == 0) {
+        return pseudoStates[i].state;
+      }
+    }
+    return 0;
+  }
+
+  static const char* scanName(const char* c, const char* end)
+  {
+    while(c < end && (isalnum((unsigned char)*c) || *c == '-' || *c == '_' || (unsigned char)*c >= 0x80)) {
+      ++c;
+    }
+    return c;
+  }
+
+  static const char* skipBlock(const char* c, const char* end, char open, char close)
+  {
+    int depth = 0;
+    for(; c < end; ++c) {
+      if(*c == open) {
+        ++depth;
+      } else if(*c == close && --depth == 0) {
+        return c + 1;
+      }
+    }
+    return end;
+  }
+
+  static inline bool isCombinator(char c)
+  {
+    return isspace((unsigned char)c) || c == '>' || c == '+' || c == '~';
+  }
+
+  // compound selectors are keyed by id, first class, tag or universal in that order
+  static const ImU32 CLASS_SEED = '.';
+  static const ImU32 ID_SEED = '#';
+
   Style::Style(Style* parent)
     : mBase(0)
+    , mStructural(0)
     , mParent(parent)
   {
     parse(cssBase, &mBase);
@@ -1363,7 +1421,214 @@ namespace ImVue {
           sheet,
           scoped
       });
+
+      // conservative scan: false positives only cost extra restyling
+      if(strstr(data, ":first-") || strstr(data, ":nth-child") || strstr(data, ":nth-of-type") || strchr(data, '+') || strchr(data, '~')) {
+        mStructural |= PRECEDING_SIBLINGS;
+      }
+
+      if(strstr(data, ":last-") || strstr(data, ":nth-last-") || strstr(data, ":only-")) {
+        mStructural |= FOLLOWING_SIBLINGS;
+      }
+
+      scanStateSelectors(data);
+    }
+  }
+
+  int Style::structural() const
+  {
+    return mStructural | (mParent ? mParent->structural() : 0);
+  }
+
+  void Style::scanStateSelectors(const char* data)
+  {
+    const char* c = data;
+    while(*c) {
+      if(c[0] == '/' && c[1] == '*') {
+        const char* close = strstr(c + 2, "*/");
+        if(!close) {
+          break;
+        }
+        c = close + 2;
+        continue;
+      }
+
+      if(isspace((unsigned char)*c) || *c == '}' || *c == ';') {
+        ++c;
+        continue;
+      }
+
+      const char* begin = c;
+      int depth = 0;
+      while(*c && *c != '{' && *c != ';') {
+        if(*c == '(') {
+          ++depth;
+        } else if(*c == ')') {
+          --depth;
+        } else if(*c == ',' && depth == 0 && *begin != '@') {
+          scanSelector(begin, c);
+          begin = c + 1;
+        }
+        ++c;
+      }
+
+      if(*c != '{') {
+        continue;
+      }
+
+      // rules nested in the at-rules are scanned as the top level ones
+      if(*begin == '@') {
+        ++c;
+        continue;
+      }
+
+      scanSelector(begin, c);
+      c = strchr(c, '}');
+      if(!c) {
+        break;
+      }
+    }
+  }
+
+  void Style::scanSelector(const char* begin, const char* end)
+  {
+    ImVector<ImU32> keys;
+    ImVector<int> states;
+
+    const char* c = begin;
+    while(c < end) {
+      if(isCombinator(*c)) {
+        ++c;
+        continue;
+      }
+
+      ImU32 tag = 0;
+      ImU32 cls = 0;
+      ImU32 id = 0;
+      int mask = 0;
+
+      while(c < end && !isCombinator(*c)) {
+        const char* name = c + 1;
+        switch(*c) {
+          case '.':
+            c = scanName(name, end);
+            if(!cls) {
+              cls = ImHashStr(name, c - name, CLASS_SEED);
+            }
+            break;
+          case '#':
+            c = scanName(name, end);
+            id = ImHashStr(name, c - name, ID_SEED);
+            break;
+          case ':':
+            while(*name == ':') {
+              ++name;
+            }
+            c = scanName(name, end);
+            mask |= pseudoState(name, c - name);
+            break;
+          case '[':
+            c = skipBlock(c, end, '[', ']');
+            break;
+          case '(':
+            {
+              // arguments of :not(), :is() and such may contain state pseudo-classes too
+              const char* close = skipBlock(c, end, '(', ')');
+              while(++c < close) {
+                if(*c == ':') {
+                  name = c + 1;
+                  c = scanName(name, close);
+                  mask |= pseudoState(name, c - name);
+                  --c;
+                }
+              }
+              c = close;
+            }
+            break;
+          default:
+            name = c;
+            c = scanName(c, end);
+            if(c == name) {
+              ++c;
+            } else {
+              tag = ImHashStr(name, c - name);
+            }
+            break;
+        }
+      }
+
+      keys.push_back(id ? id : (cls ? cls : (tag ? tag : ImHashStr("*"))));
+      states.push_back(mask);
+    }
+
+    if(keys.size() == 0) {
+      return;
+    }
+
+    int subject = keys.size() - 1;
+    if(states[subject]) {
+      mStateSelectors[keys[subject]] |= states[subject];
+    }
+
+    int ancestors = 0;
+    for(int i = 0; i < subject; ++i) {
+      if(states[i]) {
+        mAncestorStateSelectors[keys[i]] |= states[i];
+        ancestors |= states[i];
+      }
     }
+
+    if(ancestors) {
+      mStateDependents[keys[subject]] |= ancestors;
+    }
+  }
+
+  int Style::matchStates(const StateSelectors& selectors, Element* element)
+  {
+    if(selectors.empty()) {
+      return 0;
+    }
+
+    ImU32 keys[3] = {
+      ImHashStr("*"),
+      ImHashStr(element->getType()),
+      element->id ? ImHashStr(element->id, strlen(element->id), ID_SEED) : 0
+    };
+
+    int res = 0;
+    for(int i = 0; i < 3; ++i) {
+      StateSelectors::const_iterator iter = selectors.find(keys[i]);
+      if(keys[i] && iter != selectors.end()) {
+        res |= iter->second;
+      }
+    }
+
+    for(int i = 0; i < element->classes.size(); ++i) {
+      StateSelectors::const_iterator iter = selectors.find(ImHashStr(element->classes[i], strlen(element->classes[i]), CLASS_SEED));
+      if(iter != selectors.end()) {
+        res |= iter->second;
+      }
+    }
+    return res;
+  }
+
+  int Style::stateDependency(Element* element, int state) const
+  {
+    int res = 0;
+    if(matchStates(mStateSelectors, element) & state) {
+      res |= STATE_SELF;
+    }
+
+    if(matchStates(mAncestorStateSelectors, element) & state) {
+      res |= STATE_DESCENDANTS;
+    }
+
+    return res | (mParent ? mParent->stateDependency(element, state) : 0);
+  }
+
+  bool Style::dependsOnAncestorState(Element* element, int state) const
+  {
+    return (matchStates(mStateDependents, element) & state) != 0 || (mParent && mParent->dependsOnAncestorState(element, state));
   }
 
   void Style::appendSheets(css_select_ctx* ctx, bool scoped)
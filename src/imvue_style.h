@@ -39,6 +39,7 @@ extern "C" {
 }
 
 #include <iostream>
+#include <unordered_map>
 
 #include "imgui.h"
 #define IMGUI_DEFINE_MATH_OPERATORS
@@ -224,6 +225,26 @@ namespace ImVue {
         bool scoped;
       };
 
+      /**
+       * Selectors which depend on the element position among siblings
+       */
+      enum StructuralSelectors {
+        // :first-child, :nth-child, +, ~
+        PRECEDING_SIBLINGS = 1 << 0,
+        // :last-child, :nth-last-child, :only-child
+        FOLLOWING_SIBLINGS = 1 << 1
+      };
+
+      /**
+       * Elements affected by the element state change
+       */
+      enum StateDependency {
+        // selector with the state pseudo-class matches the element itself
+        STATE_SELF        = 1 << 0,
+        // selector with the state pseudo-class on the element matches its descendants
+        STATE_DESCENDANTS = 1 << 1
+      };
+
       Style(Style* parent = 0);
       ~Style();
 
@@ -239,10 +260,51 @@ namespace ImVue {
 
       void parse(const char* data, css_stylesheet** dest, bool isInline = false);
 
+      /**
+       * Get structural selectors used by the loaded sheets
+       */
+      int structural() const;
+
+      /**
+       * Get elements that may change style when the element state changes
+       *
+       * @param element element which state is changed
+       * @param state Element::ElementState mask
+       * @returns StateDependency flags
+       */
+      int stateDependency(Element* element, int state) const;
+
+      /**
+       * Check if any selector matching the element depends on the state of its ancestors
+       *
+       * @param element descendant of the element which state is changed
+       * @param state Element::ElementState mask
+       */
+      bool dependsOnAncestorState(Element* element, int state) const;
+
     private:
+      // compound selector key to the state pseudo-classes mask
+      typedef std::unordered_map<ImU32, int> StateSelectors;
+
+      /**
+       * Collect state pseudo-classes used by the sheet selectors
+       */
+      void scanStateSelectors(const char* data);
+
+      void scanSelector(const char* begin, const char* end);
+
+      static int matchStates(const StateSelectors& selectors, Element* element);
+
+      // pseudo-classes of the selector subjects
+      StateSelectors mStateSelectors;
+      // pseudo-classes of the compounds followed by a combinator
+      StateSelectors mAncestorStateSelectors;
+      // subjects of the selectors with the ancestor pseudo-classes
+      StateSelectors mStateDependents;
 
       css_stylesheet* mBase;
       ImVector<Sheet> mSheets;
+      int mStructural;
 
       Style* mParent;
 
@@ -144,6 +144,7 @@ extern "C" {
 
   Object createObject(lua_State* L);
   Object createObject(lua_State* L, int ref);
+  void pushObject(lua_State* L, const Object& object);
   Object createObject(lua_State* L, int ref, const char* key);
   Object createObject(lua_State* L, int ref, int index);
 
@@ -171,13 +172,11 @@ extern "C" {
         }
         StackGuard g(mLuaState);
         unwrap();
-        const ObjectImpl* impl = key.getImpl();
-        if(!impl) {
+        if(!key.valid()) {
           IMVUE_EXCEPTION(ScriptError, "null pointer access");
           return Object();
         }
-        const LuaObject* obj = static_cast<const LuaObject*>(impl);
-        obj->unwrap(mLuaState);
+        pushObject(mLuaState, key);
         lua_gettable(mLuaState, -2);
         return createObject(mLuaState);
       }
@@ -205,23 +204,21 @@ extern "C" {
       virtual void erase(const Object& key)
       {
         StackGuard g(mLuaState);
-        const ObjectImpl* impl = key.getImpl();
-        if(!impl) {
+        if(!key.valid()) {
           IMVUE_EXCEPTION(ScriptError, "null pointer access");
           return;
         }
-        const LuaObject* obj = static_cast<const LuaObject*>(impl);
 
         if(type() == ObjectType::USERDATA) {
           unwrap();
           lua_getfield(mLuaState, -1, "remove");
           unwrap(mLuaState);
-          obj->unwrap(mLuaState);
+          pushObject(mLuaState, key);
           lua_call(mLuaState, 2, 1);
         } else {
           unwrap();
           int table = lua_gettop(mLuaState);
-          obj->unwrap(mLuaState);
+          pushObject(mLuaState, key);
           lua_pushnil(mLuaState);
           lua_settable(mLuaState, table);
         }
@@ -232,13 +229,7 @@ extern "C" {
         unwrap();
         if(args) {
           for(int i = 0; i < nargs; ++i) {
-            const ObjectImpl* impl = args[i].getImpl();
-            if(!impl) {
-              lua_pushnil(mLuaState);
-              continue;
-            }
-            const LuaObject* obj = static_cast<const LuaObject*>(impl);
-            obj->unwrap(mLuaState);
+            pushObject(mLuaState, args[i]);
           }
         }
 
@@ -260,6 +251,10 @@ extern "C" {
 
       virtual void keys(ObjectKeys& res);
 
+      virtual bool next(Object& key, Object& value, int& cursor);
+
+      virtual size_t size();
+
       virtual long readInt() {
         StackGuard g(mLuaState);
         unwrap();
@@ -292,7 +287,7 @@ extern "C" {
           return;
         }
 
-        static_cast<LuaObject*>(object.getImpl())->unwrap(mLuaState);
+        pushObject(mLuaState, object);
         assign();
       }
 
@@ -504,11 +499,71 @@ extern "C" {
   };
 
   Object createObject(lua_State* L) {
+    // scalars are copied into the object, only tables, functions and userdata
+    // are kept in the registry
+    switch(lua_type(L, -1)) {
+      case LUA_TNIL:
+        lua_pop(L, 1);
+        return Object::nil();
+      case LUA_TBOOLEAN:
+        {
+          Object res = Object::fromBool(lua_toboolean(L, -1) != 0);
+          lua_pop(L, 1);
+          return res;
+        }
+      case LUA_TNUMBER:
+        {
+          Object res = Object::fromNumber(lua_tonumber(L, -1));
+          lua_pop(L, 1);
+          return res;
+        }
+      case LUA_TSTRING:
+        {
+          size_t len = 0;
+          const char* str = lua_tolstring(L, -1, &len);
+          if(len < Object::SHORT_STRING_SIZE) {
+            Object res = Object::fromString(str, len);
+            lua_pop(L, 1);
+            return res;
+          }
+        }
+        break;
+      default:
+        break;
+    }
+
     StackGuard g(L);
     int ref = luaL_ref(L, LUA_REGISTRYINDEX);
     return createObject(L, ref);
   }
 
+  void pushObject(lua_State* L, const Object& object)
+  {
+    const ObjectImpl* impl = object.getImpl();
+    if(impl) {
+      static_cast<const LuaObject*>(impl)->unwrap(L);
+      return;
+    }
+
+    switch(object.type()) {
+      case ObjectType::BOOLEAN:
+        lua_pushboolean(L, object.as<bool>());
+        break;
+      case ObjectType::INTEGER:
+        lua_pushinteger(L, object.as<long>());
+        break;
+      case ObjectType::NUMBER:
+        lua_pushnumber(L, object.as<double>());
+        break;
+      case ObjectType::STRING:
+        lua_pushlstring(L, object.inlineString(), object.inlineStringLength());
+        break;
+      default:
+        lua_pushnil(L);
+        break;
+    }
+  }
+
   Object createObject(lua_State* L, int ref) {
     return Object(new LuaReference(L, ref));
   }
@@ -527,23 +582,29 @@ extern "C" {
 #define IMVUE_REFMAPPER "ImVueRefMapper"
 #define IMVUE_CONTEXT "ImVueContext"
 #define IMVUE_REACTIVE_TABLE "ImVueReactiveTable"
+#define IMVUE_PROXIES "ImVueProxies"
+#define IMVUE_PROTOTYPES "ImVuePrototypes"
+#define IMVUE_TEMPORARIES "ImVueTemporaries"
 
   static int lua_insertIndex(lua_State* L);
   static int lua_removeIndex(lua_State* L);
 
+  class ReactiveTable;
+
+  static void wrapNested(lua_State* L, int index, ReactiveTable* parent, ScriptState::FieldHash path);
+
   class ReactiveTable {
     public:
-      ReactiveTable(lua_State* L, int ref, LuaScriptState* scriptState, const char* field)
+      ReactiveTable(lua_State* L, int ref, LuaScriptState* scriptState, ScriptState::FieldHash path)
         : mRef(ref)
         , mScriptState(scriptState)
-        , mField(ImStrdup(field))
+        , mPath(path)
         , mLuaState(L)
       {
       }
 
       ~ReactiveTable()
       {
-        ImGui::MemFree(mField);
         luaL_unref(mLuaState, LUA_REGISTRYINDEX, mRef);
       }
 
@@ -552,10 +613,45 @@ extern "C" {
         StackGuard g(L);
         unwrap(L);
         int top = lua_gettop(L);
+        lua_pushvalue(L, 2);
+        lua_rawget(L, top);
+        bool added = lua_isnil(L, -1);
+        bool removed = lua_isnil(L, 3);
+        // adding or removing keys changes the table itself
+        bool structural = added || removed;
+        lua_pop(L, 1);
+
+        // array changes at the boundaries are reported as splices
+        int spliceType = -1;
+        int pos = 0;
+        if(lua_type(L, 2) == LUA_TNUMBER && !(added && removed)) {
+          lua_Number n = lua_tonumber(L, 2);
+          pos = (int)n;
+          int len = (int)lua_gettablesize(L, top);
+          if((lua_Number)pos == n && pos >= 1) {
+            if(!structural && pos <= len) {
+              spliceType = ScriptState::Splice::SET;
+            } else if(added && pos == len + 1) {
+              spliceType = ScriptState::Splice::INSERT;
+            } else if(removed && pos == len) {
+              spliceType = ScriptState::Splice::REMOVE;
+            }
+          }
+        }
+
         lua_pushvalue(L, 2);
         lua_pushvalue(L, 3);
         lua_settable(L, top);
-        invalidate();
+
+        ScriptState::FieldHash path = childPath(L, 2);
+        if(spliceType != -1 && splice(L, (ScriptState::Splice::Type)spliceType, pos, removed ? 0 : 3)) {
+          if(spliceType == ScriptState::Splice::SET) {
+            mScriptState->pushChange(path);
+          }
+          return 0;
+        }
+
+        invalidate(path, structural);
         return 0;
       }
 
@@ -574,25 +670,175 @@ extern "C" {
         }
         lua_pushvalue(L, -2);
         lua_gettable(L, -2);
-        mScriptState->requested(lua_tostring(L, 2));
+        ScriptState::FieldHash path = childPath(L, 2);
+        mScriptState->requested(path);
+        if(lua_type(L, -1) == LUA_TTABLE) {
+          wrapNested(L, lua_gettop(L), this, path);
+        }
         return 1;
       }
 
+      /**
+       * pairs iterator step: nested tables are returned as reactive proxies
+       */
+      int next(lua_State* L)
+      {
+        lua_settop(L, 2);
+        unwrap(L);
+        lua_pushvalue(L, 2);
+        if(lua_next(L, 3) == 0) {
+          return 0;
+        }
+
+        ScriptState::FieldHash path = childPath(L, lua_gettop(L) - 1);
+        mScriptState->requested(path);
+        if(lua_type(L, -1) == LUA_TTABLE) {
+          wrapNested(L, lua_gettop(L), this, path);
+        }
+        return 2;
+      }
+
+      /**
+       * ipairs iterator step
+       */
+      int inext(lua_State* L)
+      {
+        int i = (int)luaL_checkinteger(L, 2) + 1;
+        unwrap(L);
+        lua_pushinteger(L, i);
+        lua_rawgeti(L, -2, i);
+        if(lua_isnil(L, -1)) {
+          return 0;
+        }
+
+        ScriptState::FieldHash path = childPath(L, lua_gettop(L) - 1);
+        mScriptState->requested(path);
+        if(lua_type(L, -1) == LUA_TTABLE) {
+          wrapNested(L, lua_gettop(L), this, path);
+        }
+        return 2;
+      }
+
       void unwrap(lua_State* L)
       {
         IM_ASSERT(mRef != LUA_NOREF);
         lua_rawgeti(L, LUA_REGISTRYINDEX, mRef);
       }
 
+      /**
+       * Notify listeners of the whole table
+       */
       inline void invalidate()
       {
-        mScriptState->pushChange(mField);
+        mScriptState->pushChange(mPath);
+        invalidateDeep();
+      }
+
+      /**
+       * Notify listeners of a single nested field
+       *
+       * @param path nested field path hash
+       * @param structural key was added or removed
+       */
+      inline void invalidate(ScriptState::FieldHash path, bool structural)
+      {
+        mScriptState->pushChange(path);
+        if(structural) {
+          mScriptState->pushChange(mPath);
+        }
+        invalidateDeep();
+      }
+
+      /**
+       * Notify splice listeners of the array layout change
+       *
+       * @param type splice type
+       * @param pos one based array index
+       * @param value stack index of the new item value, 0 if there is no value
+       * @returns false if nobody listens for the splices, so the whole table should be invalidated
+       */
+      bool splice(lua_State* L, ScriptState::Splice::Type type, int pos, int value)
+      {
+        if(!mScriptState->hasSpliceListeners(mPath)) {
+          return false;
+        }
+
+        Object object;
+        if(value != 0) {
+          StackGuard g(L);
+          lua_pushvalue(L, value);
+          if(lua_type(L, -1) == LUA_TTABLE) {
+            wrapNested(L, lua_gettop(L), this, indexPath(pos));
+          }
+          object = createObject(L);
+        }
+
+        mScriptState->pushSplice(mPath, type, pos - 1, object);
+        invalidateAncestors();
+        return true;
+      }
+
+      /**
+       * Report access to the whole table
+       */
+      inline void track()
+      {
+        mScriptState->requested(mPath);
+      }
+
+      inline ScriptState::FieldHash path() const { return mPath; }
+
+      inline LuaScriptState* scriptState() { return mScriptState; }
+
+      /**
+       * Set up nested table: changes are propagated to all the parent tables deep listeners
+       */
+      inline void inherit(const ReactiveTable& parent)
+      {
+        mAncestors = parent.mAncestors;
+        mAncestors.push_back(parent.mPath);
       }
 
     private:
+
+      inline void invalidateDeep()
+      {
+        mScriptState->pushChange(mScriptState->deepHash(mPath));
+        invalidateAncestors();
+      }
+
+      inline void invalidateAncestors()
+      {
+        for(int i = 0; i < mAncestors.size(); ++i) {
+          mScriptState->pushChange(mScriptState->deepHash(mAncestors[i]));
+        }
+      }
+
+      inline ScriptState::FieldHash childPath(lua_State* L, int key) const
+      {
+        switch(lua_type(L, key)) {
+          case LUA_TSTRING:
+            return mScriptState->hash(lua_tostring(L, key), mPath);
+          case LUA_TNUMBER:
+            {
+              lua_Number n = lua_tonumber(L, key);
+              return ImHashData(&n, sizeof(lua_Number), mPath);
+            }
+          default:
+            return mPath;
+        }
+      }
+
+      inline ScriptState::FieldHash indexPath(int pos) const
+      {
+        lua_Number n = (lua_Number)pos;
+        return ImHashData(&n, sizeof(lua_Number), mPath);
+      }
+
       int mRef;
       LuaScriptState* mScriptState;
-      char* mField;
+      ScriptState::FieldHash mPath;
+      ImVector<ScriptState::FieldHash> mAncestors;
       lua_State* mLuaState;
   };
 
@@ -612,12 +858,99 @@ extern "C" {
 
   static int lua_ImVueReactiveTableLen(lua_State* L)
   {
-    lua_GetReactiveTable(L, 1)->unwrap(L);
+    ReactiveTable* rt = lua_GetReactiveTable(L, 1);
+    rt->track();
+    rt->unwrap(L);
     size_t len = lua_gettablesize(L, -1);
     lua_pushinteger(L, len);
     return 1;
   }
 
+  static bool lua_IsReactiveTable(lua_State* L, int index)
+  {
+    if(lua_type(L, index) != LUA_TUSERDATA || !lua_getmetatable(L, index)) {
+      return false;
+    }
+
+    luaL_getmetatable(L, IMVUE_REACTIVE_TABLE);
+    bool res = lua_rawequal(L, -1, -2) != 0;
+    lua_pop(L, 2);
+    return res;
+  }
+
+  static int lua_ImVueReactiveTableNext(lua_State* L)
+  {
+    return lua_GetReactiveTable(L, 1)->next(L);
+  }
+
+  static int lua_ImVueReactiveTableINext(lua_State* L)
+  {
+    return lua_GetReactiveTable(L, 1)->inext(L);
+  }
+
+  static int lua_ImVueReactiveTablePairs(lua_State* L)
+  {
+    lua_GetReactiveTable(L, 1)->track();
+    lua_pushcfunction(L, lua_ImVueReactiveTableNext);
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    return 3;
+  }
+
+  static int lua_ImVueReactiveTableIPairs(lua_State* L)
+  {
+    lua_GetReactiveTable(L, 1)->track();
+    lua_pushcfunction(L, lua_ImVueReactiveTableINext);
+    lua_pushvalue(L, 1);
+    lua_pushinteger(L, 0);
+    return 3;
+  }
+
+  /**
+   * ImVue.pairs(t): pairs that works with reactive tables in Lua 5.1, which has no __pairs
+   */
+  static int lua_ImVuePairs(lua_State* L)
+  {
+    if(lua_IsReactiveTable(L, 1)) {
+      return lua_ImVueReactiveTablePairs(L);
+    }
+
+    luaL_checktype(L, 1, LUA_TTABLE);
+    lua_getglobal(L, "next");
+    lua_pushvalue(L, 1);
+    lua_pushnil(L);
+    return 3;
+  }
+
+  /**
+   * ImVue.ipairs(t)
+   */
+  static int lua_ImVueIPairs(lua_State* L)
+  {
+    if(lua_IsReactiveTable(L, 1)) {
+      return lua_ImVueReactiveTableIPairs(L);
+    }
+
+    lua_getglobal(L, "ipairs");
+    lua_pushvalue(L, 1);
+    lua_call(L, 1, 3);
+    return 3;
+  }
+
+  /**
+   * ImVue.raw(t): underlying table of the reactive table, writes to it are not tracked
+   */
+  static int lua_ImVueRaw(lua_State* L)
+  {
+    lua_settop(L, 1);
+    if(lua_IsReactiveTable(L, 1)) {
+      ReactiveTable* rt = lua_GetReactiveTable(L, 1);
+      rt->track();
+      rt->unwrap(L);
+    }
+    return 1;
+  }
+
   static int lua_ImVueReactiveTableDelete(lua_State* L)
   {
     ReactiveTable* rt = lua_GetReactiveTable(L, 1);
@@ -766,34 +1099,43 @@ extern "C" {
   }
 
   static int lua_insertIndex(lua_State* L) {
-    ReactiveTable* rt = lua_GetReactiveTable(L, -3);
+    // t:insert(value) appends, t:insert(pos, value) inserts at pos
+    bool append = lua_gettop(L) < 3;
+    ReactiveTable* rt = lua_GetReactiveTable(L, 1);
     int valueIndex = lua_gettop(L);
-    int keyIndex = valueIndex - 1;
     rt->unwrap(L);
     int tableIndex = lua_gettop(L);
+    int len = (int)lua_gettablesize(L, tableIndex);
+    int pos = append ? len + 1 : (int)lua_tointeger(L, 2);
     lua_getglobal(L, "table");
     lua_getfield(L, -1, "insert");
     lua_replace(L, -2); // remove _G.table
     lua_pushvalue(L, tableIndex);
-    lua_pushvalue(L, keyIndex);
+    lua_pushinteger(L, pos);
     lua_pushvalue(L, valueIndex);
     lua_call(L, 3, 0);
-    rt->invalidate();
+    if(pos < 1 || pos > len + 1 || !rt->splice(L, ScriptState::Splice::INSERT, pos, valueIndex)) {
+      rt->invalidate();
+    }
     return 0;
   }
 
   static int lua_removeIndex(lua_State* L) {
-    int index = (int)lua_tointeger(L, -1);
-    ReactiveTable* rt = lua_GetReactiveTable(L, -2);
+    ReactiveTable* rt = lua_GetReactiveTable(L, 1);
+    bool last = lua_gettop(L) < 2;
     rt->unwrap(L);
     int tableIndex = lua_gettop(L);
+    int len = (int)lua_gettablesize(L, tableIndex);
+    int pos = last ? len : (int)lua_tointeger(L, 2);
     lua_getglobal(L, "table");
     lua_getfield(L, -1, "remove");
     lua_replace(L, -2); // remove _G.table
     lua_pushvalue(L, tableIndex);
-    lua_pushinteger(L, index);
+    lua_pushinteger(L, pos);
     lua_call(L, 2, 1);
-    rt->invalidate();
+    if(pos < 1 || pos > len || !rt->splice(L, ScriptState::Splice::REMOVE, pos, 0)) {
+      rt->invalidate();
+    }
     return 1;
   }
 
@@ -843,8 +1185,8 @@ extern "C" {
       StackGuard g(L);
       lua_pushvalue(L, index);
       int ref = luaL_ref(L, LUA_REGISTRYINDEX);
-      const char* field = lua_tostring(L, keyIdx);
-      *reinterpret_cast<ReactiveTable**>(lua_newuserdata(L, sizeof(ReactiveTable*))) = new ReactiveTable(L, ref, scriptState, field);
+      ScriptState::FieldHash path = scriptState->hash(lua_tostring(L, keyIdx));
+      *reinterpret_cast<ReactiveTable**>(lua_newuserdata(L, sizeof(ReactiveTable*))) = new ReactiveTable(L, ref, scriptState, path);
       luaL_getmetatable(L, IMVUE_REACTIVE_TABLE);
       lua_setmetatable(L, -2);
       // replace table with userdata
@@ -852,6 +1194,61 @@ extern "C" {
     }
   }
 
+  /**
+   * Replaces nested table at index with a reactive proxy
+   *
+   * Proxies are cached in a weak table per script state, so reading the same nested table does not allocate,
+   * and states sharing a table do not get each other's proxies
+   */
+  static void wrapNested(lua_State* L, int index, ReactiveTable* parent, ScriptState::FieldHash path)
+  {
+    StackGuard g(L);
+    lua_getfield(L, LUA_REGISTRYINDEX, IMVUE_PROXIES);
+    if(lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      lua_createtable(L, 0, 1);
+      lua_pushvalue(L, -1);
+      lua_setfield(L, LUA_REGISTRYINDEX, IMVUE_PROXIES);
+    }
+    int states = lua_gettop(L);
+
+    lua_pushlightuserdata(L, parent->scriptState());
+    lua_rawget(L, states);
+    if(lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      lua_createtable(L, 0, 0);
+      lua_createtable(L, 0, 1);
+      lua_pushstring(L, "v");
+      lua_setfield(L, -2, "__mode");
+      lua_setmetatable(L, -2);
+      lua_pushlightuserdata(L, parent->scriptState());
+      lua_pushvalue(L, -2);
+      lua_rawset(L, states);
+    }
+    int cache = lua_gettop(L);
+
+    lua_pushvalue(L, index);
+    lua_rawget(L, cache);
+    if(!lua_isnil(L, -1) && lua_GetReactiveTable(L)->path() == path) {
+      lua_replace(L, index);
+      return;
+    }
+    lua_pop(L, 1);
+
+    lua_pushvalue(L, index);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    ReactiveTable* rt = new ReactiveTable(L, ref, parent->scriptState(), path);
+    rt->inherit(*parent);
+    *reinterpret_cast<ReactiveTable**>(lua_newuserdata(L, sizeof(ReactiveTable*))) = rt;
+    luaL_getmetatable(L, IMVUE_REACTIVE_TABLE);
+    lua_setmetatable(L, -2);
+
+    lua_pushvalue(L, index);
+    lua_pushvalue(L, -2);
+    lua_rawset(L, cache);
+    lua_replace(L, index);
+  }
+
   class RefMapper {
     public:
       RefMapper(ScriptState::RefMap* refs)
@@ -911,6 +1308,9 @@ extern "C" {
       {
         if(mScriptState) {
           const char* field = lua_tostring(L, 2);
+          if(mScriptState->isComputed(mScriptState->hash(field))) {
+            return luaL_error(L, "computed property %s is read only", field);
+          }
           mScriptState->pushChange(field);
           wrapTable(mLuaState, 3, 2, mScriptState);
         }
@@ -933,7 +1333,14 @@ extern "C" {
         }
 
         if(mScriptState) {
-          mScriptState->requested(lua_tostring(L, 2));
+          ScriptState::FieldHash h = mScriptState->hash(lua_tostring(L, 2));
+          mScriptState->requested(h);
+          if(mScriptState->isComputed(h)) {
+            if(!mScriptState->pushComputed(h)) {
+              return lua_error(L);
+            }
+            return 1;
+          }
         }
 
         lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mRef);
@@ -949,12 +1356,15 @@ extern "C" {
         mSelfRef = ref;
       }
 
-      void registerMixins(int tableIndex)
+      /**
+       * Registers mixins data, mixins methods are copied only when copyMethods is set,
+       * component instances get them from the prototype
+       */
+      void registerMixins(int tableIndex, bool copyMethods = true)
       {
         StackGuard g(mLuaState);
         IM_ASSERT(lua_istable(mLuaState, tableIndex));
-        lua_pushstring(mLuaState, "mixins");
-        lua_rawget(mLuaState, tableIndex);
+        lua_getfield(mLuaState, tableIndex, "mixins");
 
         if(!lua_istable(mLuaState, -1)) {
           return;
@@ -965,6 +1375,12 @@ extern "C" {
         lua_pushnil(mLuaState);
         while (lua_next(mLuaState, mixins) != 0) {
           int mixin = lua_gettop(mLuaState);
+          if(!copyMethods) {
+            registerData(tableIndex, mixin);
+            lua_pop(mLuaState, 1);
+            continue;
+          }
+
           lua_pushnil(mLuaState);
           while (lua_next(mLuaState, mixin) != 0) {
             if(lua_type(mLuaState, -2) == LUA_TSTRING && ImStricmp(lua_tostring(mLuaState, -2), "data") == 0) {
@@ -1062,6 +1478,77 @@ extern "C" {
     return *reinterpret_cast<ImVue**>(luaL_checkudata(L, index, IMVUE));
   }
 
+  static void copyFields(lua_State* L, int src, int dst, const char* skip = NULL)
+  {
+    lua_pushnil(L);
+    while(lua_next(L, src) != 0) {
+      if(skip && lua_type(L, -2) == LUA_TSTRING && ImStricmp(lua_tostring(L, -2), skip) == 0) {
+        lua_pop(L, 1);
+        continue;
+      }
+      lua_pushvalue(L, -2);
+      lua_insert(L, -2);
+      lua_settable(L, dst);
+    }
+  }
+
+  /**
+   * Pushes the metatable shared by all instances of the component definition at index
+   *
+   * Definition fields and mixins methods are merged into the prototype once,
+   * metatables are cached in a weak table keyed by the definition
+   */
+  static void pushPrototype(lua_State* L, int index)
+  {
+    lua_getfield(L, LUA_REGISTRYINDEX, IMVUE_PROTOTYPES);
+    if(lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      lua_createtable(L, 0, 0);
+      lua_createtable(L, 0, 1);
+      lua_pushstring(L, "k");
+      lua_setfield(L, -2, "__mode");
+      lua_setmetatable(L, -2);
+      lua_pushvalue(L, -1);
+      lua_setfield(L, LUA_REGISTRYINDEX, IMVUE_PROTOTYPES);
+    }
+    int cache = lua_gettop(L);
+
+    lua_pushvalue(L, index);
+    lua_rawget(L, cache);
+    if(!lua_isnil(L, -1)) {
+      lua_remove(L, cache);
+      return;
+    }
+    lua_pop(L, 1);
+
+    lua_createtable(L, 0, 1);
+    int meta = lua_gettop(L);
+    lua_createtable(L, 0, 0);
+    int prototype = lua_gettop(L);
+    copyFields(L, index, prototype);
+
+    // mixins data is still evaluated per instance
+    lua_pushstring(L, "mixins");
+    lua_rawget(L, index);
+    if(lua_istable(L, -1)) {
+      int mixins = lua_gettop(L);
+      lua_pushnil(L);
+      while(lua_next(L, mixins) != 0) {
+        if(lua_istable(L, -1)) {
+          copyFields(L, lua_gettop(L), prototype, "data");
+        }
+        lua_pop(L, 1);
+      }
+    }
+    lua_settop(L, prototype);
+    lua_setfield(L, meta, "__index");
+
+    lua_pushvalue(L, index);
+    lua_pushvalue(L, meta);
+    lua_rawset(L, cache);
+    lua_remove(L, cache);
+  }
+
   static int lua_CreateImVue(lua_State* L) {
     *reinterpret_cast<ImVue**>(lua_newuserdata(L, sizeof(ImVue*))) = new ImVue(L);
     luaL_getmetatable(L, IMVUE);
@@ -1125,71 +1612,568 @@ extern "C" {
     return 1;
   }
 
-  LuaScriptState::LuaScriptState(lua_State* L)
-    : mLuaState(L)
-    , mRefMapper(new RefMapper(&mRefMap))
-    , mImVue(NULL)
-    , mRef(LUA_NOREF)
-    , mLogAccess(false)
-  {
-  }
+  /**
+   * Context variables are updated in place, other names are evaluation temporaries:
+   * they are kept in the environment and listed to be removed when the evaluation ends,
+   * so nothing leaks from one evaluation to another through the environment
+   */
+  static int lua_ImVueContextNewIndex(lua_State* L) {
+    lua_settop(L, 3);
+    lua_pushvalue(L, 2);
+    lua_rawget(L, 1);
+    bool temporary = lua_type(L, -1) == LUA_TNIL;
+    lua_pop(L, 1);
 
-  LuaScriptState::~LuaScriptState()
-  {
-    delete mRefMapper;
-    if(mRef != LUA_NOREF) {
-      luaL_unref(mLuaState, LUA_REGISTRYINDEX, mRef);
+    if(temporary && !lua_isnil(L, 3)) {
+      lua_getfield(L, LUA_REGISTRYINDEX, IMVUE_TEMPORARIES);
+      int list = lua_gettop(L);
+      int size = (int)lua_gettablesize(L, list);
+      lua_pushvalue(L, 1);
+      lua_rawseti(L, list, size + 1);
+      lua_pushvalue(L, 2);
+      lua_rawseti(L, list, size + 2);
+      lua_pop(L, 1);
     }
+
+    lua_rawset(L, 1);
+    return 0;
   }
 
-  void LuaScriptState::initialize(Object data)
+  /**
+   * Get temporaries list position before running an evaluation
+   */
+  static int lua_TemporariesMark(lua_State* L)
   {
-    StackGuard g(mLuaState);
-    static_cast<LuaObject*>(data.getImpl())->unwrap(mLuaState);
-    int index = lua_gettop(mLuaState);
-    // copy table
-    lua_createtable(mLuaState, 0, 0);
-    int copyIndex = lua_gettop(mLuaState);
-    lua_pushnil(mLuaState);
-
-    while(lua_next(mLuaState, index) != 0)
-    {
-      lua_pushvalue(mLuaState, -2);
-      lua_insert(mLuaState, -2);
-      lua_settable(mLuaState, copyIndex);
-    }
-
-    lua_CreateImVue(mLuaState);
-    luaL_checkudata(mLuaState, copyIndex, IMVUE);
-    setupState(luaL_ref(mLuaState, LUA_REGISTRYINDEX));
+    lua_getfield(L, LUA_REGISTRYINDEX, IMVUE_TEMPORARIES);
+    int mark = (int)lua_gettablesize(L, -1);
+    lua_pop(L, 1);
+    return mark;
   }
 
-  void LuaScriptState::initialize(const char* scriptData)
+  /**
+   * Remove temporaries written since the mark from their environments
+   */
+  static void lua_ReleaseTemporaries(lua_State* L, int mark)
   {
-    StackGuard g(mLuaState);
-    if(luaL_dostring(mLuaState, scriptData) != 0) {
-      IMVUE_EXCEPTION(ScriptError, lua_tostring(mLuaState, -1));
-      return;
-    }
+    lua_getfield(L, LUA_REGISTRYINDEX, IMVUE_TEMPORARIES);
+    int list = lua_gettop(L);
+    for(int i = (int)lua_gettablesize(L, list); i > mark; i -= 2) {
+      lua_rawgeti(L, list, i - 1);
+      lua_rawgeti(L, list, i);
+      lua_pushnil(L);
+      lua_rawset(L, -3);
+      lua_pop(L, 1);
 
-    luaL_checkudata(mLuaState, -1, IMVUE);
-    setupState(luaL_ref(mLuaState, LUA_REGISTRYINDEX));
+      lua_pushnil(L);
+      lua_rawseti(L, list, i);
+      lua_pushnil(L);
+      lua_rawseti(L, list, i - 1);
+    }
+    lua_pop(L, 1);
   }
 
-  ScriptState* LuaScriptState::clone() const
-  {
-    return new LuaScriptState(mLuaState);
-  }
+  /**
+   * Compiled expressions storage
+   *
+   * Keeps compiled Lua chunks in the registry, so evaluating the same
+   * expression again does not involve any parsing
+   */
+  class ChunkCache {
+    public:
+      // cache is dropped entirely when it grows over this size
+      static const size_t MAX_SIZE = 4096;
 
-  MutableObject LuaScriptState::operator[](const char* key) {
-    return MutableObject(new LuaFieldReference(mLuaState, mRef, key));
-  }
+      struct Chunk {
+        char* source;
+        int ref;
+        bool returns;
+      };
 
-  bool LuaScriptState::runScript(const char* script, ScriptState::Context* ctx)
-  {
-    int err = luaL_loadstring(mLuaState, script);
-    if(err != 0) {
-      if(err == LUA_ERRSYNTAX)
+      ChunkCache(lua_State* L)
+        : enabled(true)
+        , mLuaState(L)
+      {
+        memset(&mStats, 0, sizeof(LuaScriptState::ChunkCacheStats));
+      }
+
+      ~ChunkCache()
+      {
+        clear();
+      }
+
+      /**
+       * Find compiled chunk and push it to the stack
+       *
+       * @param str expression source
+       * @param returns expression should return value
+       *
+       * @returns true if chunk was found
+       */
+      bool push(const char* str, bool returns)
+      {
+        if(!enabled) {
+          return false;
+        }
+
+        // fast path: same source pointer
+        Chunk* chunk = NULL;
+        SourceMap::iterator iter = mBySource.find(str);
+        if(iter != mBySource.end() && matches(iter->second, str, returns)) {
+          chunk = iter->second;
+        } else {
+          Chunks::iterator it = mChunks.find(hash(str, returns));
+          if(it != mChunks.end() && matches(it->second, str, returns)) {
+            chunk = it->second;
+            remember(str, chunk);
+          }
+        }
+
+        if(!chunk) {
+          mStats.misses++;
+          return false;
+        }
+
+        mStats.hits++;
+        lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, chunk->ref);
+        return true;
+      }
+
+      /**
+       * Store compiled chunk from the top of the stack
+       */
+      void store(const char* str, bool returns)
+      {
+        if(!enabled) {
+          return;
+        }
+
+        if(mChunks.size() >= MAX_SIZE) {
+          clear();
+        }
+
+        ScriptState::FieldHash h = hash(str, returns);
+        Chunks::iterator it = mChunks.find(h);
+        if(it != mChunks.end()) {
+          // hash collision, replace old chunk
+          release(it->second);
+          mChunks.erase(it);
+          mBySource.clear();
+        }
+
+        lua_pushvalue(mLuaState, -1);
+        Chunk* chunk = new Chunk{ImStrdup(str), luaL_ref(mLuaState, LUA_REGISTRYINDEX), returns};
+        mChunks[h] = chunk;
+        remember(str, chunk);
+      }
+
+      void clear()
+      {
+        for(Chunks::iterator iter = mChunks.begin(); iter != mChunks.end(); ++iter) {
+          release(iter->second);
+        }
+        mChunks.clear();
+        mBySource.clear();
+      }
+
+      LuaScriptState::ChunkCacheStats stats() const
+      {
+        LuaScriptState::ChunkCacheStats res = mStats;
+        res.size = mChunks.size();
+        return res;
+      }
+
+      bool enabled;
+
+    private:
+
+      inline ScriptState::FieldHash hash(const char* str, bool returns) const
+      {
+        return ImHashStr(str, 0, returns ? 1 : 0);
+      }
+
+      inline bool matches(Chunk* chunk, const char* str, bool returns) const
+      {
+        return chunk->returns == returns && std::strcmp(chunk->source, str) == 0;
+      }
+
+      inline void remember(const char* str, Chunk* chunk)
+      {
+        // temporary source strings can leave a lot of stale pointers
+        if(mBySource.size() >= MAX_SIZE) {
+          mBySource.clear();
+        }
+        mBySource[str] = chunk;
+      }
+
+      void release(Chunk* chunk)
+      {
+        luaL_unref(mLuaState, LUA_REGISTRYINDEX, chunk->ref);
+        ImGui::MemFree(chunk->source);
+        delete chunk;
+      }
+
+      typedef std::unordered_map<ScriptState::FieldHash, Chunk*> Chunks;
+      typedef std::unordered_map<const char*, Chunk*> SourceMap;
+
+      Chunks mChunks;
+      SourceMap mBySource;
+      LuaScriptState::ChunkCacheStats mStats;
+      lua_State* mLuaState;
+  };
+
+  /**
+   * Persistent environment table of the ScriptState::Context
+   */
+  class LuaEnvironment : public ScriptState::Context::Environment {
+    public:
+      LuaEnvironment(lua_State* L)
+        : ref(LUA_NOREF)
+        , version(0)
+        , mLuaState(L)
+      {
+      }
+
+      ~LuaEnvironment()
+      {
+        if(ref != LUA_NOREF) {
+          luaL_unref(mLuaState, LUA_REGISTRYINDEX, ref);
+        }
+      }
+
+      int ref;
+      unsigned int version;
+
+    private:
+      lua_State* mLuaState;
+  };
+
+  /**
+   * Several expressions compiled into a single Lua function
+   */
+  class ExpressionBatch {
+    public:
+      // generated function keeps all expressions as locals
+      static const int MAX_EXPRESSIONS = 150;
+
+      ExpressionBatch(lua_State* L)
+        : ref(LUA_NOREF)
+        , mLuaState(L)
+      {
+      }
+
+      ~ExpressionBatch()
+      {
+        if(ref != LUA_NOREF) {
+          luaL_unref(mLuaState, LUA_REGISTRYINDEX, ref);
+        }
+
+        for(int i = 0; i < sources.size(); ++i) {
+          ImGui::MemFree(sources[i]);
+        }
+      }
+
+      void add(const char* str)
+      {
+        sources.push_back(ImStrdup(str));
+        hashes.push_back(ImHashStr(str));
+      }
+
+      /**
+       * Generates function source: each expression result is stored in a local,
+       * __mark splits access log between expressions
+       */
+      std::string generate() const
+      {
+        std::stringstream ss;
+        ss << "local __mark = ...\n";
+        for(int i = 0; i < sources.size(); ++i) {
+          ss << "local __r" << i << " = ";
+          if(std::strstr(sources[i], "return") == NULL) {
+            ss << "(" << sources[i] << "\n)";
+          } else {
+            ss << "(function() " << sources[i] << "\nend)()";
+          }
+          ss << "; __mark()\n";
+        }
+
+        ss << "return ";
+        for(int i = 0; i < sources.size(); ++i) {
+          ss << (i == 0 ? "" : ", ") << "__r" << i;
+        }
+        return ss.str();
+      }
+
+      int find(const char* str) const
+      {
+        ScriptState::FieldHash h = ImHashStr(str);
+        for(int i = 0; i < hashes.size(); ++i) {
+          if(hashes[i] == h && std::strcmp(sources[i], str) == 0) {
+            return i;
+          }
+        }
+
+        return -1;
+      }
+
+      void reset()
+      {
+        values.clear();
+        fields.clear();
+        marks.clear();
+      }
+
+      ImVector<char*> sources;
+      ImVector<ScriptState::FieldHash> hashes;
+
+      // evaluation results
+      std::vector<Object> values;
+      std::vector<ScriptState::Fields> fields;
+      ImVector<int> marks;
+
+      int ref;
+
+    private:
+      lua_State* mLuaState;
+  };
+
+  /**
+   * Memoized computed property
+   *
+   * Dependencies are collected from the access log during evaluation,
+   * the value is recomputed on the next read after any of them is changed,
+   * including reads made in the same tick before the changes are flushed
+   */
+  class ComputedProperty : public ScriptState::Observer {
+    public:
+      ComputedProperty(lua_State* L, ScriptState* state, ScriptState::FieldHash h, int function)
+        : ScriptState::Observer(true)
+        , function(function)
+        , value(LUA_NOREF)
+        , dirty(true)
+        , evaluating(false)
+        , mLuaState(L)
+        , mScriptState(state)
+        , mHash(h)
+      {
+      }
+
+      ~ComputedProperty()
+      {
+        luaL_unref(mLuaState, LUA_REGISTRYINDEX, function);
+        if(value != LUA_NOREF) {
+          luaL_unref(mLuaState, LUA_REGISTRYINDEX, value);
+        }
+      }
+
+      void notify(ScriptState::FieldHash field)
+      {
+        (void)field;
+        if(!dirty) {
+          dirty = true;
+          mScriptState->pushChange(mHash);
+        }
+      }
+
+      int function;
+      int value;
+      bool dirty;
+      bool evaluating;
+
+    private:
+      lua_State* mLuaState;
+      ScriptState* mScriptState;
+      ScriptState::FieldHash mHash;
+  };
+
+  /**
+   * Lua watch callback: handler(self, value, oldValue)
+   */
+  class LuaWatcher : public ScriptState::Watcher {
+    public:
+      LuaWatcher(lua_State* L, ScriptState* state, int self, int handler, const char* path, bool deep)
+        : ScriptState::Watcher(state)
+        , mLuaState(L)
+        , mSelf(self)
+        , mHandler(handler)
+        , mValue(LUA_NOREF)
+        , mPath(path)
+        , mDeep(deep)
+      {
+      }
+
+      ~LuaWatcher()
+      {
+        luaL_unref(mLuaState, LUA_REGISTRYINDEX, mHandler);
+        if(mValue != LUA_NOREF) {
+          luaL_unref(mLuaState, LUA_REGISTRYINDEX, mValue);
+        }
+      }
+
+      void run()
+      {
+        StackGuard g(mLuaState);
+        lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mHandler);
+        lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mSelf);
+        pushValue();
+        int value = lua_gettop(mLuaState);
+        if(mValue != LUA_NOREF) {
+          lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mValue);
+          // parent fields changes notify the watcher even if the watched value stays the same,
+          // deep watchers also run when the same table is modified
+          if(!mDeep && lua_rawequal(mLuaState, value, -1)) {
+            return;
+          }
+          luaL_unref(mLuaState, LUA_REGISTRYINDEX, mValue);
+        } else {
+          lua_pushnil(mLuaState);
+        }
+        lua_pushvalue(mLuaState, value);
+        mValue = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+
+        if(lua_pcall(mLuaState, 3, 0, 0) != 0) {
+          IMVUE_EXCEPTION(ScriptError, "watcher %s failed: %s", mPath.get(), lua_tostring(mLuaState, -1));
+        }
+      }
+
+      /**
+       * Remember current value without running the handler
+       */
+      void init()
+      {
+        StackGuard g(mLuaState);
+        pushValue();
+        mValue = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+      }
+
+    private:
+
+      void pushValue()
+      {
+        lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mSelf);
+        const char* path = mPath.get();
+        while(path && !lua_isnil(mLuaState, -1)) {
+          const char* end = strchr(path, '.');
+          size_t len = end ? (size_t)(end - path) : strlen(path);
+          lua_pushlstring(mLuaState, path, len);
+          lua_gettable(mLuaState, -2);
+          lua_remove(mLuaState, -2);
+          path = end ? end + 1 : NULL;
+        }
+      }
+
+      lua_State* mLuaState;
+      int mSelf;
+      int mHandler;
+      int mValue;
+      ImString mPath;
+      bool mDeep;
+  };
+
+  LuaScriptState::LuaScriptState(lua_State* L)
+    : mLuaState(L)
+    , mRefMapper(new RefMapper(&mRefMap))
+    , mImVue(NULL)
+    , mChunkCache(std::make_shared<ChunkCache>(L))
+    , mActiveBatch(NULL)
+    , mRef(LUA_NOREF)
+    , mEnvRef(LUA_NOREF)
+    , mLogAccess(false)
+  {
+  }
+
+  LuaScriptState::LuaScriptState(lua_State* L, std::shared_ptr<ChunkCache> cache)
+    : mLuaState(L)
+    , mRefMapper(new RefMapper(&mRefMap))
+    , mImVue(NULL)
+    , mChunkCache(cache)
+    , mActiveBatch(NULL)
+    , mRef(LUA_NOREF)
+    , mEnvRef(LUA_NOREF)
+    , mLogAccess(false)
+  {
+  }
+
+  LuaScriptState::~LuaScriptState()
+  {
+    clearWatchers();
+    clearComputed();
+    delete mRefMapper;
+    for(size_t i = 0; i < mBatches.size(); ++i) {
+      if(mBatches[i]) {
+        delete mBatches[i];
+      }
+    }
+    if(mRef != LUA_NOREF) {
+      luaL_unref(mLuaState, LUA_REGISTRYINDEX, mRef);
+    }
+
+    if(mEnvRef != LUA_NOREF) {
+      luaL_unref(mLuaState, LUA_REGISTRYINDEX, mEnvRef);
+    }
+
+    // drop nested proxies cache of this state
+    lua_getfield(mLuaState, LUA_REGISTRYINDEX, IMVUE_PROXIES);
+    if(lua_istable(mLuaState, -1)) {
+      lua_pushlightuserdata(mLuaState, this);
+      lua_pushnil(mLuaState);
+      lua_rawset(mLuaState, -3);
+    }
+    lua_pop(mLuaState, 1);
+  }
+
+  void LuaScriptState::initialize(Object data)
+  {
+    StackGuard g(mLuaState);
+    pushObject(mLuaState, data);
+    int index = lua_gettop(mLuaState);
+    // instance table inherits methods from the definition prototype
+    lua_createtable(mLuaState, 0, 0);
+    int instanceIndex = lua_gettop(mLuaState);
+    pushPrototype(mLuaState, index);
+    lua_setmetatable(mLuaState, instanceIndex);
+
+    lua_CreateImVue(mLuaState);
+    luaL_checkudata(mLuaState, instanceIndex, IMVUE);
+    setupState(luaL_ref(mLuaState, LUA_REGISTRYINDEX), true);
+  }
+
+  void LuaScriptState::initialize(const char* scriptData)
+  {
+    StackGuard g(mLuaState);
+    if(luaL_dostring(mLuaState, scriptData) != 0) {
+      IMVUE_EXCEPTION(ScriptError, lua_tostring(mLuaState, -1));
+      return;
+    }
+
+    luaL_checkudata(mLuaState, -1, IMVUE);
+    setupState(luaL_ref(mLuaState, LUA_REGISTRYINDEX));
+  }
+
+  ScriptState* LuaScriptState::clone() const
+  {
+    return new LuaScriptState(mLuaState, mChunkCache);
+  }
+
+  MutableObject LuaScriptState::operator[](const char* key) {
+    return MutableObject(new LuaFieldReference(mLuaState, mRef, key));
+  }
+
+  bool LuaScriptState::loadChunk(const char* str, bool returns)
+  {
+    if(mChunkCache->push(str, returns)) {
+      return true;
+    }
+
+    std::stringstream script;
+    if(returns && std::strstr(str, "return") == NULL) {
+      script << "return ";
+    }
+
+    script << str;
+
+    int err = luaL_loadstring(mLuaState, script.str().c_str());
+    if(err != 0) {
+      if(err == LUA_ERRSYNTAX)
         handleError(lua_tostring(mLuaState, -1));
       else if(err == LUA_ERRMEM)
         handleError("memory allocation error");
@@ -1199,12 +2183,25 @@ extern "C" {
       return false;
     }
 
+    mChunkCache->store(str, returns);
+    return true;
+  }
+
+  bool LuaScriptState::runScript(const char* str, bool returns, ScriptState::Context* ctx)
+  {
+    if(!loadChunk(str, returns)) {
+      return false;
+    }
+
     activateContext(ctx);
+    int mark = lua_TemporariesMark(mLuaState);
     if(lua_pcall(mLuaState, 0, LUA_MULTRET, 0)) {
+      lua_ReleaseTemporaries(mLuaState, mark);
       handleError(lua_tostring(mLuaState, -1));
       return false;
     }
 
+    lua_ReleaseTemporaries(mLuaState, mark);
     return true;
   }
 
@@ -1215,20 +2212,13 @@ extern "C" {
     }
 
     StackGuard g(mLuaState);
-    std::stringstream script;
-    std::string data(str);
-    if(retval && data.find("return") == std::string::npos) {
-      script << "return ";
-    }
-
-    script << str;
 
     if(fields) {
       mLogAccess = true;
     }
 
     int functionIndex = lua_gettop(mLuaState);
-    bool success = runScript(&script.str()[0], ctx);
+    bool success = runScript(str, retval != 0, ctx);
     mLogAccess = false;
 
     if(!success) {
@@ -1273,19 +2263,24 @@ extern "C" {
       return Object();
     }
 
-    std::stringstream script;
-    std::string data(str);
-    if(data.find("return") == std::string::npos) {
-      script << "return ";
+    if(mActiveBatch) {
+      int index = mActiveBatch->find(str);
+      if(index != -1) {
+        Fields& log = mActiveBatch->fields[index];
+        if(fields && log.size() > 0) {
+          int offset = fields->size();
+          fields->resize(offset + log.size());
+          memcpy(&fields->Data[offset], &log[0], sizeof(FieldHash) * log.size());
+        }
+        return mActiveBatch->values[index];
+      }
     }
 
-    script << str;
-
     if(fields) {
       mLogAccess = true;
     }
 
-    bool success = runScript(&script.str()[0], ctx);
+    bool success = runScript(str, true, ctx);
     mLogAccess = false;
 
     if(!success) {
@@ -1303,6 +2298,130 @@ extern "C" {
     return createObject(mLuaState);
   }
 
+  int LuaScriptState::compileBatch(const ImVector<const char*>& expressions)
+  {
+    if(expressions.size() == 0 || expressions.size() > ExpressionBatch::MAX_EXPRESSIONS) {
+      return 0;
+    }
+
+    StackGuard g(mLuaState);
+    ExpressionBatch* batch = new ExpressionBatch(mLuaState);
+    for(int i = 0; i < expressions.size(); ++i) {
+      batch->add(expressions[i]);
+    }
+
+    std::string source = batch->generate();
+    if(!mChunkCache->push(source.c_str(), false)) {
+      if(luaL_loadstring(mLuaState, source.c_str()) != 0) {
+        // can't be batched, expressions will be evaluated one by one
+        delete batch;
+        return 0;
+      }
+      mChunkCache->store(source.c_str(), false);
+    }
+
+    batch->ref = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+    for(size_t i = 0; i < mBatches.size(); ++i) {
+      if(!mBatches[i]) {
+        mBatches[i] = batch;
+        return (int)i + 1;
+      }
+    }
+
+    mBatches.push_back(batch);
+    return (int)mBatches.size();
+  }
+
+  bool LuaScriptState::beginBatch(int id, ScriptState::Context* ctx)
+  {
+    if(id <= 0 || id > (int)mBatches.size() || !mBatches[id - 1] || !mImVue || mActiveBatch) {
+      return false;
+    }
+
+    StackGuard g(mLuaState);
+    ExpressionBatch* batch = mBatches[id - 1];
+    batch->reset();
+
+    int top = lua_gettop(mLuaState);
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, batch->ref);
+    mAccessLog.clear();
+    mLogAccess = true;
+    activateContext(ctx);
+    // context variables access is shared by all the expressions
+    int base = mAccessLog.size();
+
+    mActiveBatch = batch;
+    lua_pushlightuserdata(mLuaState, this);
+    lua_pushcclosure(mLuaState, &LuaScriptState::markBatch, 1);
+    int mark = lua_TemporariesMark(mLuaState);
+    int err = lua_pcall(mLuaState, 1, LUA_MULTRET, 0);
+    lua_ReleaseTemporaries(mLuaState, mark);
+    mLogAccess = false;
+
+    int count = batch->sources.size();
+    if(err != 0 || lua_gettop(mLuaState) - top != count || batch->marks.size() != count) {
+      // errors are reported by the regular evaluation
+      mActiveBatch = NULL;
+      mAccessLog.clear();
+      batch->reset();
+      return false;
+    }
+
+    batch->values.resize(count);
+    batch->fields.resize(count);
+    int start = base;
+    for(int i = 0; i < count; ++i) {
+      Fields& log = batch->fields[i];
+      int end = batch->marks[i];
+      log.reserve(base + end - start);
+      for(int j = 0; j < base; ++j) {
+        log.push_back(mAccessLog[j]);
+      }
+
+      for(int j = start; j < end; ++j) {
+        log.push_back(mAccessLog[j]);
+      }
+      start = end;
+
+      lua_pushvalue(mLuaState, top + 1 + i);
+      batch->values[i] = createObject(mLuaState, luaL_ref(mLuaState, LUA_REGISTRYINDEX));
+    }
+
+    mAccessLog.clear();
+    return true;
+  }
+
+  void LuaScriptState::endBatch()
+  {
+    if(mActiveBatch) {
+      mActiveBatch->reset();
+      mActiveBatch = NULL;
+    }
+  }
+
+  void LuaScriptState::releaseBatch(int id)
+  {
+    if(id <= 0 || id > (int)mBatches.size() || !mBatches[id - 1]) {
+      return;
+    }
+
+    if(mActiveBatch == mBatches[id - 1]) {
+      endBatch();
+    }
+
+    delete mBatches[id - 1];
+    mBatches[id - 1] = NULL;
+  }
+
+  int LuaScriptState::markBatch(lua_State* L)
+  {
+    LuaScriptState* state = static_cast<LuaScriptState*>(lua_touserdata(L, lua_upvalueindex(1)));
+    if(state->mActiveBatch) {
+      state->mActiveBatch->marks.push_back(state->mAccessLog.size());
+    }
+    return 0;
+  }
+
   void LuaScriptState::lifecycleCallback(ScriptState::LifecycleCallbackType cb)
   {
     if(!mImVue) {
@@ -1337,6 +2456,34 @@ extern "C" {
     }
   }
 
+  bool LuaScriptState::reactivePath(const Object& object, FieldHash& path)
+  {
+    const ObjectImpl* impl = object.getImpl();
+    if(!impl || impl->type() != ObjectType::USERDATA) {
+      return false;
+    }
+
+    StackGuard g(mLuaState);
+    static_cast<const LuaObject*>(impl)->unwrap(mLuaState);
+    if(!lua_getmetatable(mLuaState, -1)) {
+      return false;
+    }
+
+    luaL_getmetatable(mLuaState, IMVUE_REACTIVE_TABLE);
+    if(!lua_rawequal(mLuaState, -1, -2)) {
+      return false;
+    }
+
+    path = lua_GetReactiveTable(mLuaState, -3)->path();
+    return true;
+  }
+
+  Object LuaScriptState::createInteger(long value)
+  {
+    lua_pushinteger(mLuaState, value);
+    return createObject(mLuaState);
+  }
+
   void LuaScriptState::requested(ScriptState::FieldHash h)
   {
     if(mLogAccess) {
@@ -1349,7 +2496,7 @@ extern "C" {
     requested(hash(field));
   }
 
-  void LuaScriptState::setupState(int ref)
+  void LuaScriptState::setupState(int ref, bool inherited)
   {
     StackGuard g(mLuaState);
     if(mImVue) {
@@ -1358,6 +2505,14 @@ extern "C" {
       mImVue = 0;
     }
 
+    if(mEnvRef != LUA_NOREF) {
+      luaL_unref(mLuaState, LUA_REGISTRYINDEX, mEnvRef);
+      mEnvRef = LUA_NOREF;
+    }
+
+    clearWatchers();
+    clearComputed();
+
     lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, ref);
     ImVue* imvue = lua_GetImVue(mLuaState);
 
@@ -1367,17 +2522,180 @@ extern "C" {
     imvue->unwrap();
     int tableIndex = lua_gettop(mLuaState);
     imvue->initEnvironment(ref);
-    imvue->registerMixins(tableIndex);
+    imvue->registerMixins(tableIndex, !inherited);
     imvue->registerData(tableIndex);
+    registerComputed(tableIndex);
     mRef = ref;
     mImVue = imvue;
+
+    std::vector<LuaWatcher*> immediate = registerWatchers(tableIndex);
+    for(size_t i = 0; i < immediate.size(); ++i) {
+      immediate[i]->run();
+    }
+  }
+
+  std::vector<LuaWatcher*> LuaScriptState::registerWatchers(int tableIndex)
+  {
+    StackGuard g(mLuaState);
+    std::vector<LuaWatcher*> immediate;
+    lua_getfield(mLuaState, tableIndex, "watch");
+    if(!lua_istable(mLuaState, -1)) {
+      return immediate;
+    }
+
+    int watch = lua_gettop(mLuaState);
+    lua_pushnil(mLuaState);
+    while(lua_next(mLuaState, watch) != 0) {
+      if(lua_type(mLuaState, -2) != LUA_TSTRING) {
+        lua_pop(mLuaState, 1);
+        continue;
+      }
+
+      // watch = { field = handler } or { field = { handler = handler, deep = true, immediate = true } }
+      bool deep = false;
+      bool runImmediately = false;
+      int def = lua_gettop(mLuaState);
+      if(lua_istable(mLuaState, def)) {
+        lua_getfield(mLuaState, def, "deep");
+        deep = lua_toboolean(mLuaState, -1) != 0;
+        lua_getfield(mLuaState, def, "immediate");
+        runImmediately = lua_toboolean(mLuaState, -1) != 0;
+        lua_getfield(mLuaState, def, "handler");
+      } else {
+        lua_pushvalue(mLuaState, def);
+      }
+
+      if(lua_type(mLuaState, -1) != LUA_TFUNCTION) {
+        IMVUE_EXCEPTION(ScriptError, "watcher %s must define a handler function", lua_tostring(mLuaState, def - 1));
+        lua_settop(mLuaState, def - 1);
+        continue;
+      }
+
+      const char* path = lua_tostring(mLuaState, def - 1);
+      LuaWatcher* watcher = new LuaWatcher(mLuaState, this, mRef, luaL_ref(mLuaState, LUA_REGISTRYINDEX), path, deep);
+      mWatchers.push_back(watcher);
+
+      // nested paths are hashed the same way reactive tables do,
+      // replacing any of the parent tables changes the watched value too
+      ScriptState::FieldHash h = 0;
+      char* p = ImStrdup(path);
+      for(char* segment = p; segment;) {
+        char* end = strchr(segment, '.');
+        if(end) {
+          *end = '\0';
+        }
+        h = segment == p ? hash(segment) : hash(segment, h);
+        segment = end ? end + 1 : NULL;
+        if(segment) {
+          addObserver(h, watcher);
+        }
+      }
+      ImGui::MemFree(p);
+
+      addWatcher(h, watcher, deep);
+      if(runImmediately) {
+        immediate.push_back(watcher);
+      } else {
+        watcher->init();
+      }
+      lua_settop(mLuaState, def - 1);
+    }
+    return immediate;
+  }
+
+  void LuaScriptState::clearWatchers()
+  {
+    for(size_t i = 0; i < mWatchers.size(); ++i) {
+      removeWatcher(mWatchers[i]);
+      delete mWatchers[i];
+    }
+    mWatchers.clear();
+  }
+
+  void LuaScriptState::registerComputed(int tableIndex)
+  {
+    StackGuard g(mLuaState);
+    lua_getfield(mLuaState, tableIndex, "computed");
+    if(!lua_istable(mLuaState, -1)) {
+      return;
+    }
+
+    int computed = lua_gettop(mLuaState);
+    lua_pushnil(mLuaState);
+    while(lua_next(mLuaState, computed) != 0) {
+      if(lua_type(mLuaState, -2) == LUA_TSTRING && lua_type(mLuaState, -1) == LUA_TFUNCTION) {
+        ScriptState::FieldHash h = hash(lua_tostring(mLuaState, -2));
+        lua_pushvalue(mLuaState, -1);
+        int function = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+        if(mComputed.count(h) != 0) {
+          removeObserver(mComputed[h]);
+          delete mComputed[h];
+        }
+        mComputed[h] = new ComputedProperty(mLuaState, this, h, function);
+      }
+      lua_pop(mLuaState, 1);
+    }
+  }
+
+  void LuaScriptState::clearComputed()
+  {
+    for(ComputedProperties::iterator iter = mComputed.begin(); iter != mComputed.end(); ++iter) {
+      removeObserver(iter->second);
+      delete iter->second;
+    }
+    mComputed.clear();
+  }
+
+  bool LuaScriptState::pushComputed(ScriptState::FieldHash h)
+  {
+    ComputedProperty* computed = mComputed[h];
+    if(!computed->dirty) {
+      lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, computed->value);
+      return true;
+    }
+
+    if(computed->evaluating) {
+      lua_pushstring(mLuaState, "computed property depends on itself");
+      return false;
+    }
+
+    // collect dependencies into the access log tail and drop them after,
+    // so the outer expression depends on the computed property only
+    bool logAccess = mLogAccess;
+    int offset = mAccessLog.size();
+    mLogAccess = true;
+    computed->evaluating = true;
+
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, computed->function);
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mRef);
+    int err = lua_pcall(mLuaState, 1, 1, 0);
+
+    computed->evaluating = false;
+    mLogAccess = logAccess;
+
+    removeObserver(computed);
+    for(int i = offset; i < mAccessLog.size(); ++i) {
+      addObserver(mAccessLog[i], computed);
+    }
+    mAccessLog.resize(offset);
+
+    if(err != 0) {
+      return false;
+    }
+
+    if(computed->value != LUA_NOREF) {
+      luaL_unref(mLuaState, LUA_REGISTRYINDEX, computed->value);
+    }
+    lua_pushvalue(mLuaState, -1);
+    computed->value = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+    computed->dirty = false;
+    return true;
   }
 
   void LuaScriptState::setObject(char* key, Object& value, int tableIndex)
   {
     StackGuard g(mLuaState);
-    LuaObject* v = static_cast<LuaObject*>(value.getImpl());
-    if(!v) {
+    if(!value.valid()) {
       IMVUE_EXCEPTION(ScriptError, "tried to set null value in context");
       return;
     }
@@ -1386,11 +2704,11 @@ extern "C" {
       lua_pushstring(mLuaState, key);
     }
 
-    v->unwrap();
+    pushObject(mLuaState, value);
     if(tableIndex < 0) {
       lua_setglobal(mLuaState, key);
     } else {
-      lua_settable(mLuaState, tableIndex);
+      lua_rawset(mLuaState, tableIndex);
     }
   }
 
@@ -1399,27 +2717,83 @@ extern "C" {
     StackGuard g(mLuaState);
     lua_getupvalue(mLuaState, -1, 1);
     int func = lua_gettop(mLuaState);
-    lua_createtable(mLuaState, 0, 0);
-    luaL_getmetatable(mLuaState, IMVUE_CONTEXT);
-    lua_setmetatable(mLuaState, -2);
+
+    if(!ctx) {
+      // evaluations without context share the same environment
+      pushEnvironment();
+      lua_setfenv(mLuaState, func);
+      return;
+    }
+
+    // environment table is created once per context and updated only when variables change
+    LuaEnvironment* env = static_cast<LuaEnvironment*>(ctx->env);
+    bool outdated = env == NULL || env->version != ctx->version;
+    if(!env) {
+      env = new LuaEnvironment(mLuaState);
+      lua_createtable(mLuaState, 0, (int)ctx->vars.size() + 1);
+      luaL_getmetatable(mLuaState, IMVUE_CONTEXT);
+      lua_setmetatable(mLuaState, -2);
+      lua_pushvalue(mLuaState, -1);
+      env->ref = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+      ctx->env = env;
+    } else {
+      lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, env->ref);
+    }
 
     int index = lua_gettop(mLuaState);
-    if(ctx) {
+    if(outdated) {
       for(size_t i = 0; i < ctx->vars.size(); ++i) {
         ScriptState::Variable& var = ctx->vars[i];
         setObject(var.key, var.value, index);
-        requested(ctx->hash);
       }
+      env->version = ctx->version;
     }
 
+    if(ctx->vars.size() > 0) {
+      requested(ctx->hash);
+    }
+
+    // the same context can be shared by the component and it's parent state
     lua_pushstring(mLuaState, "self");
     lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mRef);
-    lua_settable(mLuaState, index);
+    lua_rawset(mLuaState, index);
 
     lua_pushvalue(mLuaState, index);
     lua_setfenv(mLuaState, func);
   }
 
+  void LuaScriptState::pushEnvironment()
+  {
+    if(mEnvRef != LUA_NOREF) {
+      lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mEnvRef);
+      return;
+    }
+
+    lua_createtable(mLuaState, 0, 1);
+    luaL_getmetatable(mLuaState, IMVUE_CONTEXT);
+    lua_setmetatable(mLuaState, -2);
+
+    lua_pushstring(mLuaState, "self");
+    lua_rawgeti(mLuaState, LUA_REGISTRYINDEX, mRef);
+    lua_rawset(mLuaState, -3);
+
+    lua_pushvalue(mLuaState, -1);
+    mEnvRef = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
+  }
+
+  LuaScriptState::ChunkCacheStats LuaScriptState::getChunkCacheStats() const
+  {
+    return mChunkCache->stats();
+  }
+
+  void LuaScriptState::setChunkCacheEnabled(bool value)
+  {
+    mChunkCache->enabled = value;
+    if(!value) {
+      mChunkCache->clear();
+    }
+  }
+
   void registerBindings(lua_State* L)
   {
     lua_pushnumber(L, ImGuiWindowFlags_NoBackground);
@@ -1574,6 +2948,9 @@ extern "C" {
       static const luaL_Reg imvueFuncs[] = {
         {"new", lua_CreateImVue},
         {"component", lua_ImVueCreateComponent},
+        {"pairs", lua_ImVuePairs},
+        {"ipairs", lua_ImVueIPairs},
+        {"raw", lua_ImVueRaw},
         {"__newindex", lua_ImVueNewIndex},
         {"__index", lua_ImVueIndex},
         {"__gc", lua_DeleteImVue},
@@ -1595,10 +2972,14 @@ extern "C" {
     if(luaL_newmetatable(L, IMVUE_CONTEXT)) {
       static const luaL_Reg contextFuncs[] = {
         {"__index", lua_ImVueContextIndex},
+        {"__newindex", lua_ImVueContextNewIndex},
         {NULL, NULL}
       };
       luaL_setfuncs(L, contextFuncs, 0);
       lua_setglobal(L, IMVUE_CONTEXT);
+
+      lua_createtable(L, 0, 0);
+      lua_setfield(L, LUA_REGISTRYINDEX, IMVUE_TEMPORARIES);
     }
 
     if(luaL_newmetatable(L, IMVUE_REACTIVE_TABLE)) {
@@ -1606,6 +2987,8 @@ extern "C" {
         {"__index", lua_ImVueReactiveTableIndex},
         {"__newindex", lua_ImVueReactiveTableNewIndex},
         {"__len", lua_ImVueReactiveTableLen},
+        {"__pairs", lua_ImVueReactiveTablePairs},
+        {"__ipairs", lua_ImVueReactiveTableIPairs},
         {"__gc", lua_ImVueReactiveTableDelete},
         {NULL, NULL}
       };
@@ -1659,6 +3042,93 @@ extern "C" {
     }
   }
 
+  size_t LuaObject::size() {
+    StackGuard g(mLuaState);
+    unwrap();
+    switch(type()) {
+      case ObjectType::USERDATA:
+        lua_GetReactiveTable(mLuaState)->unwrap(mLuaState);
+        break;
+      case ObjectType::ARRAY:
+      case ObjectType::OBJECT:
+        break;
+      default:
+        return 0;
+    }
+
+    return lua_gettablesize(mLuaState, -1);
+  }
+
+  bool LuaObject::next(Object& key, Object& value, int& cursor) {
+    StackGuard g(mLuaState);
+    unwrap();
+    int source = lua_gettop(mLuaState);
+    switch(type()) {
+      case ObjectType::USERDATA:
+        lua_GetReactiveTable(mLuaState)->unwrap(mLuaState);
+        break;
+      case ObjectType::ARRAY:
+      case ObjectType::OBJECT:
+        break;
+      default:
+        return false;
+    }
+
+    int table = lua_gettop(mLuaState);
+    int length = (int)lua_gettablesize(mLuaState, table);
+
+    // sequential part is walked by index, the length operator may count holes in, so nils are skipped
+    if(cursor >= 0) {
+      while(cursor < length) {
+        ++cursor;
+        lua_rawgeti(mLuaState, table, cursor);
+        if(lua_isnil(mLuaState, -1)) {
+          lua_pop(mLuaState, 1);
+          continue;
+        }
+
+        key = Object::fromNumber(cursor);
+        if(source != table) {
+          // values of reactive tables are read through the proxy
+          lua_pop(mLuaState, 1);
+          lua_pushinteger(mLuaState, cursor);
+          lua_gettable(mLuaState, source);
+        }
+        value = createObject(mLuaState);
+        return true;
+      }
+
+      cursor = -1;
+      lua_pushnil(mLuaState);
+    } else {
+      pushObject(mLuaState, key);
+    }
+
+    while(lua_next(mLuaState, table) != 0) {
+      if(lua_type(mLuaState, -2) == LUA_TNUMBER) {
+        lua_Number index = lua_tonumber(mLuaState, -2);
+        if(index >= 1 && index <= length && index == (lua_Number)(int)index) {
+          // already visited
+          lua_pop(mLuaState, 1);
+          continue;
+        }
+      }
+
+      if(source != table) {
+        lua_pop(mLuaState, 1);
+        lua_pushvalue(mLuaState, -1);
+        lua_gettable(mLuaState, source);
+      }
+
+      value = createObject(mLuaState);
+      lua_pushvalue(mLuaState, -1);
+      key = createObject(mLuaState);
+      return true;
+    }
+
+    return false;
+  }
+
   void LuaObject::keys(ObjectKeys& res) {
     StackGuard g(mLuaState);
     unwrap();
@@ -1675,20 +3145,13 @@ extern "C" {
 
     int index = lua_gettop(mLuaState);
     lua_pushnil(mLuaState);
-    ImVector<int> refs;
+    res.clear();
 
     while(lua_next(mLuaState, index) != 0)
     {
       lua_pop(mLuaState, 1);
       lua_pushvalue(mLuaState, -1);
-      int ref = luaL_ref(mLuaState, LUA_REGISTRYINDEX);
-      refs.push_back(ref);
-    }
-
-    res.resize(refs.size());
-
-    for(int i = 0; i < refs.size(); i++) {
-      res[i] = createObject(mLuaState, refs[i]);
+      res.push_back(createObject(mLuaState));
     }
   }
 } // namespace ImVue
@@ -26,6 +26,8 @@ SOFTWARE.
 #include "imvue_script.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <unordered_map>
 
 struct lua_State;
 struct luaL_Reg;
@@ -34,10 +36,23 @@ namespace ImVue {
   class ImVue;
   class Element;
   class RefMapper;
+  class ChunkCache;
+  class ExpressionBatch;
+  class ComputedProperty;
+  class LuaWatcher;
 
   class LuaScriptState : public ScriptState
   {
     public:
+      /**
+       * Compiled expressions cache counters
+       */
+      struct ChunkCacheStats {
+        size_t hits;
+        size_t misses;
+        size_t size;
+      };
+
       LuaScriptState(lua_State* L);
       virtual ~LuaScriptState();
 
@@ -77,6 +92,21 @@ namespace ImVue {
 
       Object getObject(const char* str, Fields* fields = 0, ScriptState::Context* ctx = 0);
 
+      /**
+       * Compiles expressions into one Lua function
+       */
+      int compileBatch(const ImVector<const char*>& expressions);
+
+      bool beginBatch(int batch, ScriptState::Context* ctx = 0);
+
+      void endBatch();
+
+      void releaseBatch(int batch);
+
+      bool reactivePath(const Object& object, FieldHash& path);
+
+      Object createInteger(long value);
+
       /**
        * Removes all field listeners
        */
@@ -91,12 +121,62 @@ namespace ImVue {
 
       void requested(const char* field);
 
+      /**
+       * Get compiled expressions cache counters
+       */
+      ChunkCacheStats getChunkCacheStats() const;
+
+      /**
+       * Enable or disable compiled expressions cache
+       *
+       * Cache is shared between the state and all it's clones
+       */
+      void setChunkCacheEnabled(bool value);
+
     private:
       friend class ImVue;
 
-      void setupState(int ref);
+      LuaScriptState(lua_State* L, std::shared_ptr<ChunkCache> cache);
+
+      /**
+       * @param inherited the state table gets methods from the prototype metatable
+       */
+      void setupState(int ref, bool inherited = false);
+
+      /**
+       * Read computed properties definitions from the component table
+       */
+      void registerComputed(int tableIndex);
+
+      void clearComputed();
+
+      /**
+       * Read watchers definitions from the component table
+       *
+       * @returns watchers that should be run immediately
+       */
+      std::vector<LuaWatcher*> registerWatchers(int tableIndex);
+
+      void clearWatchers();
+
+      inline bool isComputed(ScriptState::FieldHash h) const {
+        return mComputed.count(h) != 0;
+      }
+
+      /**
+       * Push computed property value, evaluates it if any dependency was changed
+       *
+       * @returns false if evaluation failed, error message is pushed instead of the value
+       */
+      bool pushComputed(ScriptState::FieldHash h);
+
+      bool loadChunk(const char* script, bool returns);
+
+      bool runScript(const char* script, bool returns, ScriptState::Context* ctx);
+
+      void pushEnvironment();
 
-      bool runScript(const char* script, ScriptState::Context* ctx);
+      static int markBatch(lua_State* L);
 
       typedef ImVector<ScriptState::FieldHash> FieldAccessLog;
 
@@ -108,7 +188,14 @@ namespace ImVue {
       FieldAccessLog mAccessLog;
       RefMapper* mRefMapper;
       ImVue* mImVue;
+      std::shared_ptr<ChunkCache> mChunkCache;
+      std::vector<ExpressionBatch*> mBatches;
+      ExpressionBatch* mActiveBatch;
+      typedef std::unordered_map<ScriptState::FieldHash, ComputedProperty*> ComputedProperties;
+      ComputedProperties mComputed;
+      std::vector<LuaWatcher*> mWatchers;
       int mRef;
+      int mEnvRef;
       int mFuncUpvalue;
 
       bool mLogAccess;
@@ -76,6 +76,31 @@ BENCHMARK_DEFINE_F(ImVueBenchmark, RenderImVueStatic)(benchmark::State& state) {
   }
 };
 
+#define CACHED_ITEMS_COUNT 200
+
+/**
+ * Renders a large read-only panel
+ * Arg(1) enables draw output cache for the panel
+ */
+BENCHMARK_DEFINE_F(ImVueBenchmark, RenderImVueCached)(benchmark::State& state) {
+  ImVue::Document document;
+  std::stringstream ss;
+
+  ss << "<style>button { padding: 4px; border: 1px solid #FF0000; }</style>";
+  ss << "<template><window name=\"panel\"><group" << (state.range(0) ? " cache" : "") << ">";
+  for(size_t i = 0; i < CACHED_ITEMS_COUNT; ++i) {
+    ss << "<button>item" << i << "</button>";
+  }
+  ss << "</group></window></template>";
+
+  document.parse(&ss.str()[0]);
+  for (auto _ : state) {
+    beforeRender();
+    document.render();
+    afterRender();
+  }
+};
+
 #if defined(WITH_LUA)
 
 #include "imgui_lua_bindings.h"
@@ -193,11 +218,149 @@ BENCHMARK_DEFINE_F(ImVueBenchmark, RenderImVueStyled)(benchmark::State& state) {
   lua_close(L);
 }
 
+#define EXPRESSION_COUNT 100
+
+/**
+ * Evaluates the same set of expressions over and over
+ * Arg(0) runs with compiled expressions cache disabled
+ */
+BENCHMARK_DEFINE_F(ImVueBenchmark, EvalExpressions)(benchmark::State& state) {
+  lua_State * L = luaL_newstate();
+  luaL_openlibs(L);
+  ImVue::registerBindings(L);
+  {
+    ImVue::LuaScriptState* script = new ImVue::LuaScriptState(L);
+    ImVue::Document document(ImVue::createContext(
+      ImVue::createElementFactory(),
+      script
+    ));
+
+    document.parse(
+      "<template></template>"
+      "<script>"
+      "return ImVue.new({"
+        "data = function() return { value = 1, name = 'window' } end"
+      "})"
+      "</script>"
+    );
+
+    std::vector<std::string> expressions;
+    for(size_t i = 0; i < EXPRESSION_COUNT; ++i) {
+      std::stringstream ss;
+      ss << "self.name .. tostring(self.value + " << i << ")";
+      expressions.push_back(ss.str());
+    }
+
+    script->setChunkCacheEnabled(state.range(0) != 0);
+    for (auto _ : state) {
+      for(size_t i = 0; i < EXPRESSION_COUNT; ++i) {
+        ImVue::Object res = script->getObject(expressions[i].c_str());
+        benchmark::DoNotOptimize(res);
+      }
+    }
+
+    ImVue::LuaScriptState::ChunkCacheStats stats = script->getChunkCacheStats();
+    state.counters["hits"] = stats.hits;
+    state.counters["misses"] = stats.misses;
+  }
+  lua_close(L);
+}
+
+/**
+ * Builds v-for list of state.range(0) items and tears it down
+ */
+BENCHMARK_DEFINE_F(ImVueBenchmark, BuildDestroyList)(benchmark::State& state) {
+  lua_State * L = luaL_newstate();
+  luaL_openlibs(L);
+  ImVue::registerBindings(L);
+
+  std::stringstream ss;
+  ss << "<template><window name=\"list\">"
+    "<button v-for=\"(item, i) in self.items\" :id=\"'b' .. i\">{{item.name}}</button>"
+    "</window></template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function()\n"
+        "local items = {}\n"
+        "for i = 1, " << state.range(0) << " do items[i] = { name = 'item' .. i } end\n"
+        "return { items = items }\n"
+      "end"
+    "})"
+    "</script>";
+  std::string data = ss.str();
+
+  ImVue::ElementPool::Stats stats;
+  for (auto _ : state) {
+    ImVue::Context* ctx = ImVue::createContext(
+      ImVue::createElementFactory(),
+      new ImVue::LuaScriptState(L)
+    );
+    ImVue::Document document(ctx);
+    document.parse(&data[0]);
+    beforeRender();
+    document.render();
+    afterRender();
+    stats = ctx->pool->getStats();
+  }
+
+  state.counters["pool_kb"] = stats.reserved / 1024;
+  state.counters["pool_used_kb"] = stats.peak / 1024;
+  state.counters["sizeof_element"] = sizeof(ImVue::Element);
+  state.counters["row_bytes"] = (double)stats.peak / state.range(0);
+  lua_close(L);
+}
+
+/**
+ * Build list of components, stateful or functional
+ */
+BENCHMARK_DEFINE_F(ImVueBenchmark, BuildComponentList)(benchmark::State& state) {
+  lua_State * L = luaL_newstate();
+  luaL_openlibs(L);
+  ImVue::registerBindings(L);
+
+  std::stringstream ss;
+  ss << "<template><window name=\"list\">"
+    "<list-item v-for=\"item in self.items\" :label=\"item.name\"/>"
+    "</window></template>"
+    "<script>"
+    "local Item = ImVue.component('list-item', {"
+      "functional = " << (state.range(0) ? "true" : "false") << ","
+      "props = { label = { type = ImVue_String } },"
+      "template = '<button>{{ " << (state.range(0) ? "label" : "self.label") << " }}</button>'"
+    "})\n"
+    "return ImVue.new({"
+      "components = { Item },"
+      "data = function()\n"
+        "local items = {}\n"
+        "for i = 1, 1000 do items[i] = { name = 'item' .. i } end\n"
+        "return { items = items }\n"
+      "end"
+    "})"
+    "</script>";
+  std::string data = ss.str();
+
+  for (auto _ : state) {
+    ImVue::Document document(ImVue::createContext(
+      ImVue::createElementFactory(),
+      new ImVue::LuaScriptState(L)
+    ));
+    document.parse(&data[0]);
+    beforeRender();
+    document.render();
+    afterRender();
+  }
+  lua_close(L);
+}
+
 BENCHMARK_REGISTER_F(ImVueBenchmark, RenderImVueScripted);
 BENCHMARK_REGISTER_F(ImVueBenchmark, RenderImVueStyled);
+BENCHMARK_REGISTER_F(ImVueBenchmark, EvalExpressions)->Arg(0)->Arg(1);
+BENCHMARK_REGISTER_F(ImVueBenchmark, BuildDestroyList)->Arg(1000)->Arg(5000);
+BENCHMARK_REGISTER_F(ImVueBenchmark, BuildComponentList)->Arg(0)->Arg(1);
 #endif
 
 BENCHMARK_REGISTER_F(ImVueBenchmark, RenderImVueStatic);
+BENCHMARK_REGISTER_F(ImVueBenchmark, RenderImVueCached)->Arg(0)->Arg(1);
 BENCHMARK_REGISTER_F(ImVueBenchmark, RenderImGuiStatic);
 // Run the benchmark
 BENCHMARK_MAIN();
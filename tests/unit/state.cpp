@@ -120,6 +120,142 @@ TEST_F(LuaScriptStateTest, TestState)
   renderDocument(document);
 }
 
+TEST_F(LuaScriptStateTest, TestChunkCache)
+{
+  ImVue::LuaScriptState* script = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        script
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"static\">"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function(self)\n"
+        "return { value = 1 }\n"
+      "end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+
+  ImVue::LuaScriptState::ChunkCacheStats before = script->getChunkCacheStats();
+  for(int i = 0; i < 10; ++i) {
+    EXPECT_EQ(script->getObject("self.value + 1").as<int>(), 2);
+  }
+  ImVue::LuaScriptState::ChunkCacheStats after = script->getChunkCacheStats();
+  EXPECT_EQ(after.misses - before.misses, 1u);
+  EXPECT_EQ(after.hits - before.hits, 9u);
+
+  script->eval("self.value = 5");
+  EXPECT_EQ(script->getObject("self.value + 1").as<int>(), 6);
+
+  script->setChunkCacheEnabled(false);
+  EXPECT_EQ(script->getChunkCacheStats().size, 0u);
+  EXPECT_EQ(script->getObject("self.value + 1").as<int>(), 6);
+  EXPECT_EQ(script->getChunkCacheStats().size, 0u);
+}
+
+TEST_F(LuaScriptStateTest, TestBatchEvaluation)
+{
+  ImVue::LuaScriptState* script = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        script
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"static\">"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function(self)\n"
+        "return { a = 1, b = 2, calls = 0 }\n"
+      "end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+
+  ImVector<const char*> expressions;
+  expressions.push_back("self.a");
+  expressions.push_back("self.b + 1");
+  expressions.push_back("self.calls = self.calls + 1; return self.calls");
+  int batch = script->compileBatch(expressions);
+  ASSERT_NE(batch, 0);
+
+  ASSERT_TRUE(script->beginBatch(batch));
+  ImVue::ScriptState::Fields fields;
+  EXPECT_EQ(script->getObject("self.b + 1", &fields).as<int>(), 3);
+  EXPECT_GT(fields.size(), 0);
+  EXPECT_EQ(script->getObject("self.a").as<int>(), 1);
+  EXPECT_EQ(script->getObject("self.calls = self.calls + 1; return self.calls").as<int>(), 1);
+  // evaluated once per batch
+  EXPECT_EQ(script->getObject("self.calls = self.calls + 1; return self.calls").as<int>(), 1);
+  script->endBatch();
+
+  EXPECT_EQ(script->getObject("self.calls").as<int>(), 1);
+  script->releaseBatch(batch);
+  EXPECT_FALSE(script->beginBatch(batch));
+
+  // invalid expressions can't be batched
+  expressions.clear();
+  expressions.push_back("self.a +");
+  EXPECT_EQ(script->compileBatch(expressions), 0);
+}
+
+TEST_F(LuaScriptStateTest, TestBatchedUpdates)
+{
+  ImVue::LuaScriptState* script = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        script
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"batched\">"
+    "<selectable id=\"item\" :selected=\"self.value > 1\" :flags=\"self.flags\">{{ 'item ' .. self.value }}</selectable>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function(self)\n"
+        "return { value = 1, flags = 0 }\n"
+      "end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVector<ImVue::Selectable*> items = document.getChildren<ImVue::Selectable>("#item", true);
+  ASSERT_EQ(items.size(), 1);
+  EXPECT_STREQ(items[0]->label, "item 1");
+  EXPECT_FALSE(items[0]->selected);
+
+  // dirty bindings of the element are re-read by a single batch call
+  ImVue::LuaScriptState::ChunkCacheStats before = script->getChunkCacheStats();
+  script->eval("self.value = 2");
+  renderDocument(document, 2);
+  ImVue::LuaScriptState::ChunkCacheStats after = script->getChunkCacheStats();
+  // the only chunk is the eval above
+  EXPECT_EQ((after.hits + after.misses) - (before.hits + before.misses), 1u);
+  EXPECT_STREQ(items[0]->label, "item 2");
+  EXPECT_TRUE(items[0]->selected);
+
+  // a single dirty binding is evaluated directly
+  before = script->getChunkCacheStats();
+  script->eval("self.flags = 1");
+  renderDocument(document, 2);
+  after = script->getChunkCacheStats();
+  EXPECT_EQ((after.hits + after.misses) - (before.hits + before.misses), 2u);
+  EXPECT_EQ(items[0]->flags, 1);
+}
+
 TEST_F(LuaScriptStateTest, TestReactivity)
 {
   ImVue::Document document(ImVue::createContext(
@@ -213,6 +349,717 @@ TEST_F(LuaScriptStateTest, TestReactivity)
   EXPECT_STREQ(element->text, "01");
 }
 
+class PushingObserver : public ImVue::ScriptState::Observer {
+  public:
+    PushingObserver(ImVue::ScriptState* state, ImVue::ScriptState::FieldHash target)
+      : calls(0)
+      , mState(state)
+      , mTarget(target)
+    {
+    }
+
+    void notify(ImVue::ScriptState::FieldHash field)
+    {
+      (void)field;
+      calls++;
+      if(mTarget) {
+        mState->pushChange(mTarget);
+      }
+    }
+
+    int calls;
+  private:
+    ImVue::ScriptState* mState;
+    ImVue::ScriptState::FieldHash mTarget;
+};
+
+TEST_F(LuaScriptStateTest, TestChangesPushedDuringFlush)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  state->initialize("return ImVue.new({})");
+
+  ImVue::ScriptState::FieldHash first = state->hash("first");
+  ImVue::ScriptState::FieldHash second = state->hash("second");
+  PushingObserver firstObserver(state, 0);
+  PushingObserver secondObserver(state, first);
+  state->addObserver(first, &firstObserver);
+  state->addObserver(second, &secondObserver);
+
+  // first is processed before second pushes it again
+  state->pushChange(first);
+  state->pushChange(second);
+  state->update();
+  EXPECT_EQ(firstObserver.calls, 2);
+  EXPECT_EQ(secondObserver.calls, 1);
+  EXPECT_FALSE(state->hasPendingChanges());
+
+  state->removeObserver(&firstObserver);
+  state->removeObserver(&secondObserver);
+  delete state;
+}
+
+TEST_F(LuaScriptStateTest, TestEvalTemporaries)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"temporaries\">"
+      "<text-unformatted v-for=\"item in self.items\">{{item}}{{(function() last = item; return last end)()}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = { 'a', 'b' }"
+      "} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  // temporaries are readable during the evaluation only
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 2);
+  EXPECT_STREQ(items[0]->text, "aa");
+  EXPECT_STREQ(items[1]->text, "bb");
+  lua_getglobal(L, "last");
+  EXPECT_TRUE(lua_isnil(L, -1));
+  lua_pop(L, 1);
+
+  // handler temporary is dropped with the evaluation of the shared environment
+  state->eval("tmp = self.items[1]; self.first = tmp");
+  EXPECT_STREQ(state->getObject("self.first").as<ImString>().get(), "a");
+  EXPECT_TRUE(state->getObject("tmp == nil").as<bool>());
+  lua_getglobal(L, "tmp");
+  EXPECT_TRUE(lua_isnil(L, -1));
+  lua_pop(L, 1);
+
+  // globals stay readable, context variables are not removed
+  luaL_dostring(L, "shared = 'global'");
+  EXPECT_STREQ(state->getObject("shared").as<ImString>().get(), "global");
+  EXPECT_STREQ(state->getObject("self ~= nil and 'ok'").as<ImString>().get(), "ok");
+  renderDocument(document, 2);
+  items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 2);
+  EXPECT_STREQ(items[1]->text, "bb");
+}
+
+TEST_F(LuaScriptStateTest, TestSparseArrayIteration)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"sparse\">"
+      "<text-unformatted v-for=\"(item, i) in self.items\">{{i}}{{item}}</text-unformatted>"
+      "<button v-for=\"item in plain\">{{item}}</button>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "plain = { 'x', nil, 'z' }\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = { 'a', nil, 'c', nil, 'e' }"
+      "} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  // holes do not produce empty rows
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[0]->text, "1a");
+  EXPECT_STREQ(items[1]->text, "3c");
+  EXPECT_STREQ(items[2]->text, "5e");
+
+  ImVector<ImVue::Button*> plain = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(plain.size(), 2);
+  EXPECT_STREQ(plain[0]->label, "x");
+  EXPECT_STREQ(plain[1]->label, "z");
+
+  state->eval("self.items[2] = 'b'");
+  renderDocument(document, 2);
+  items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 4);
+  EXPECT_STREQ(items[1]->text, "2b");
+}
+
+TEST_F(LuaScriptStateTest, TestEmbeddedZeros)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"zeros\">"
+      "<text-unformatted v-for=\"item in self.items\">{{#item}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = { 'a\\0b', string.rep('c\\0', 20) }"
+      "} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  // short strings are kept inline, long ones by reference: both keep the full length
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 2);
+  EXPECT_STREQ(items[0]->text, "3");
+  EXPECT_STREQ(items[1]->text, "40");
+
+  ImVue::Object value = state->getObject("'a\\0b'");
+  ImVue::Object copy = value;
+  ASSERT_NE(copy.inlineString(), (const char*)NULL);
+  EXPECT_EQ(copy.inlineStringLength(), 3u);
+  EXPECT_EQ(memcmp(copy.inlineString(), "a\0b", 3), 0);
+}
+
+TEST_F(LuaScriptStateTest, TestNestedReactivity)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"nested\">"
+      "<text-unformatted id=\"title\">{{tick(self.config.window.title)}}</text-unformatted>"
+      "<text-unformatted id=\"other\">{{self.config.other}}</text-unformatted>"
+      "<button v-for=\"value in self.config.window\">{{value}}</button>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "evals = 0\n"
+    "function tick(value) evals = evals + 1; return value end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "config = { window = { title = 'a' }, other = 1 }"
+      "} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVector<ImVue::TextUnformatted*> title = document.getChildren<ImVue::TextUnformatted>("#title", true);
+  ImVector<ImVue::TextUnformatted*> other = document.getChildren<ImVue::TextUnformatted>("#other", true);
+  ASSERT_EQ(title.size(), 1);
+  ASSERT_EQ(other.size(), 1);
+  EXPECT_STREQ(title[0]->text, "a");
+
+  int evals = 0;
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 1);
+
+  // sibling field change does not touch the title binding
+  state->eval("self.config.other = 2");
+  renderDocument(document, 2);
+  EXPECT_STREQ(other[0]->text, "2");
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 1);
+
+  state->eval("self.config.window.title = 'b'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(title[0]->text, "b");
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 2);
+
+  // v-for is rebuilt on nested changes
+  ImVector<ImVue::Button*> buttons = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(buttons.size(), 1);
+  EXPECT_STREQ(buttons[0]->label, "b");
+
+  state->eval("self.config.window.size = 'big'");
+  renderDocument(document, 3);
+  buttons = document.getChildren<ImVue::Button>("button", true);
+  EXPECT_EQ(buttons.size(), 2);
+}
+
+TEST_F(LuaScriptStateTest, TestNestedIteration)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"iteration\">"
+      "<text-unformatted id=\"sum\">{{self.sum}}</text-unformatted>"
+      "<text-unformatted id=\"names\">{{self.names}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = { { name = 'a', value = 1 }, { name = 'b', value = 2 } }"
+      "} end,"
+      "computed = {"
+        "sum = function(self)"
+          " local res = 0"
+          " for _, item in ImVue.ipairs(self.items) do res = res + item.value end"
+          " return res"
+        " end,"
+        "names = function(self)"
+          " local res = {}"
+          " for _, item in ImVue.pairs(self.items) do"
+          "   local fields = 0"
+          "   for _ in ImVue.pairs(item) do fields = fields + 1 end"
+          "   res[#res + 1] = item.name .. fields"
+          " end"
+          " table.sort(res)"
+          " return table.concat(res, ',')"
+        " end"
+      "}"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVector<ImVue::TextUnformatted*> sum = document.getChildren<ImVue::TextUnformatted>("#sum", true);
+  ImVector<ImVue::TextUnformatted*> names = document.getChildren<ImVue::TextUnformatted>("#names", true);
+  ASSERT_EQ(sum.size(), 1);
+  ASSERT_EQ(names.size(), 1);
+  EXPECT_STREQ(sum[0]->text, "3");
+  EXPECT_STREQ(names[0]->text, "a2,b2");
+
+  // items returned by the iterators are reactive proxies
+  state->eval("self.items[2].value = 5");
+  renderDocument(document, 2);
+  EXPECT_STREQ(sum[0]->text, "6");
+
+  state->eval("self.items[1].extra = true");
+  state->eval("self.items[3] = { name = 'c', value = 1 }");
+  renderDocument(document, 2);
+  EXPECT_STREQ(sum[0]->text, "7");
+  EXPECT_STREQ(names[0]->text, "a3,b2,c2");
+
+  // plain tables fall back to the default iteration
+  EXPECT_EQ(state->getObject("local res = 0; for _, v in ImVue.ipairs({1, 2, 3}) do res = res + v end; return res").as<int>(), 6);
+  EXPECT_STREQ(state->getObject("type(ImVue.raw(self.items))").as<ImString>().get(), "table");
+}
+
+TEST_F(LuaScriptStateTest, TestNestedStandardLibrary)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"stdlib\">"
+      "<text-unformatted id=\"items\">{{table.concat(ImVue.raw(self.config.items), ',')}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "config = { items = { 3, 1, 2 }, meta = { name = 'x' } }"
+      "} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("#items", true);
+  ASSERT_EQ(items.size(), 1);
+  EXPECT_STREQ(items[0]->text, "3,1,2");
+
+  EXPECT_STREQ(state->getObject("type(ImVue.raw(self.config.meta))").as<ImString>().get(), "table");
+  EXPECT_STREQ(state->getObject("next(ImVue.raw(self.config.meta))").as<ImString>().get(), "name");
+  EXPECT_EQ(state->getObject("#ImVue.raw(self.config.items)").as<int>(), 3);
+  EXPECT_EQ(state->getObject("select('#', (table.unpack or unpack)(ImVue.raw(self.config.items)))").as<int>(), 3);
+
+  // raw writes are not tracked, assigning the table back notifies the listeners
+  state->eval("local list = ImVue.raw(self.config.items); table.sort(list); self.config.items = list");
+  renderDocument(document, 2);
+  EXPECT_STREQ(items[0]->text, "1,2,3");
+}
+
+TEST_F(LuaScriptStateTest, TestSharedNestedTable)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"shared\">"
+      "<viewer/>"
+      "<viewer/>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "shared = { inner = { value = 1 } }\n"
+    "instances = {}\n"
+    "local Viewer = ImVue.component('viewer', {"
+      "data = function() return { config = shared } end,"
+      "created = function(self) instances[#instances + 1] = self end,"
+      "template = '<text-unformatted id=\"value\">{{self.config.inner.value}}</text-unformatted>'"
+    "})\n"
+    "return ImVue.new({"
+      "components = { Viewer }"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVector<ImVue::TextUnformatted*> values = document.getChildren<ImVue::TextUnformatted>("#value", true);
+  ASSERT_EQ(values.size(), 2);
+  EXPECT_STREQ(values[0]->text, "1");
+  EXPECT_STREQ(values[1]->text, "1");
+
+  // the write goes through the proxy of the second component state
+  luaL_dostring(L, "instances[2].config.inner.value = 5");
+  renderDocument(document, 2);
+  EXPECT_STREQ(values[1]->text, "5");
+}
+
+TEST_F(LuaScriptStateTest, TestComputed)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"computed\">"
+      "<text-unformatted id=\"a\">{{self.fullName}}</text-unformatted>"
+      "<text-unformatted id=\"b\">{{self.fullName}}</text-unformatted>"
+      "<text-unformatted id=\"c\">{{self.greeting}}</text-unformatted>"
+      "<text-unformatted id=\"other\">{{self.other}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "evals = 0\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "first = 'john', last = 'doe', other = 1"
+      "} end,\n"
+      "computed = {"
+        "fullName = function(self) evals = evals + 1; return self.first .. ' ' .. self.last end,\n"
+        "greeting = function(self) return 'hi ' .. self.fullName end"
+      "}"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVector<ImVue::TextUnformatted*> a = document.getChildren<ImVue::TextUnformatted>("#a", true);
+  ImVector<ImVue::TextUnformatted*> c = document.getChildren<ImVue::TextUnformatted>("#c", true);
+  ASSERT_EQ(a.size(), 1);
+  ASSERT_EQ(c.size(), 1);
+  EXPECT_STREQ(a[0]->text, "john doe");
+  EXPECT_STREQ(c[0]->text, "hi john doe");
+
+  int evals = 0;
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 1);
+
+  // unrelated change does not invalidate the cached value
+  state->eval("self.other = 2");
+  renderDocument(document, 2);
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 1);
+
+  // dependency change recomputes the value once for all bindings
+  state->eval("self.last = 'smith'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(a[0]->text, "john smith");
+  EXPECT_STREQ(c[0]->text, "hi john smith");
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 2);
+}
+
+TEST_F(LuaScriptStateTest, TestComputedSameTick)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"computed\">"
+      "<text-unformatted id=\"a\">{{self.greeting}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "first = 'john', last = 'doe', items = {1, 2}"
+      "} end,\n"
+      "computed = {"
+        "fullName = function(self) return self.first .. ' ' .. self.last end,\n"
+        "greeting = function(self) return 'hi ' .. self.fullName end,\n"
+        "count = function(self) return #self.items end"
+      "}"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+  EXPECT_STREQ(state->getObject("self.greeting").as<ImString>().get(), "hi john doe");
+  EXPECT_EQ(state->getObject("self.count").as<int>(), 2);
+
+  // changes are not flushed yet, computed values must be recomputed on read
+  state->eval("self.first = 'jane'");
+  EXPECT_STREQ(state->getObject("self.fullName").as<ImString>().get(), "jane doe");
+  EXPECT_STREQ(state->getObject("self.greeting").as<ImString>().get(), "hi jane doe");
+
+  EXPECT_STREQ(state->getObject("self.last = 'smith'; return self.fullName").as<ImString>().get(), "jane smith");
+
+  state->eval("self.items[3] = 3");
+  EXPECT_EQ(state->getObject("self.count").as<int>(), 3);
+
+  renderDocument(document, 2);
+  ImVector<ImVue::TextUnformatted*> a = document.getChildren<ImVue::TextUnformatted>("#a", true);
+  ASSERT_EQ(a.size(), 1);
+  EXPECT_STREQ(a[0]->text, "hi jane smith");
+}
+
+TEST_F(LuaScriptStateTest, TestWatchers)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  const char* data = "<template>"
+    "<window name=\"watchers\">"
+      "<text-unformatted>{{self.count}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "calls = { count = 0, deep = 0, nested = 0, immediate = 0 }\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "count = 0, config = { window = { title = 'a' } }"
+      "} end,\n"
+      "watch = {"
+        "count = function(self, value, old) calls.count = calls.count + 1; calls.value = value; calls.old = old end,\n"
+        "config = { handler = function(self) calls.deep = calls.deep + 1 end, deep = true },\n"
+        "['config.window.title'] = function(self, value) calls.nested = calls.nested + 1; calls.title = value end,\n"
+        "other = { handler = function(self) calls.immediate = calls.immediate + 1 end, immediate = true }"
+      "}"
+    "})"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  int count = 0;
+  getLuaVariable(L, "calls", "immediate", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "calls", "count", count);
+  EXPECT_EQ(count, 0);
+
+  // repeated changes run the watcher once
+  state->eval("for i = 1, 10 do self.count = i end");
+  renderDocument(document, 2);
+  getLuaVariable(L, "calls", "count", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "calls", "value", count);
+  EXPECT_EQ(count, 10);
+  getLuaVariable(L, "calls", "old", count);
+  EXPECT_EQ(count, 0);
+
+  state->eval("self.config.window.title = 'b'");
+  renderDocument(document, 2);
+  getLuaVariable(L, "calls", "deep", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "calls", "nested", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "calls", "count", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "calls", "immediate", count);
+  EXPECT_EQ(count, 1);
+
+  // replacing parent tables changes the watched value
+  state->eval("self.config = { window = { title = 'c' } }");
+  renderDocument(document, 2);
+  getLuaVariable(L, "calls", "nested", count);
+  EXPECT_EQ(count, 2);
+
+  state->eval("self.config.window = { title = 'd' }");
+  renderDocument(document, 2);
+  getLuaVariable(L, "calls", "nested", count);
+  EXPECT_EQ(count, 3);
+
+  // the handler is not run if the value stays the same
+  state->eval("self.config.window = { title = 'd' }; self.count = 10");
+  renderDocument(document, 2);
+  getLuaVariable(L, "calls", "nested", count);
+  EXPECT_EQ(count, 3);
+  getLuaVariable(L, "calls", "count", count);
+  EXPECT_EQ(count, 1);
+}
+
+TEST_F(LuaScriptStateTest, TestInlineObjects)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"test\"/>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "flag = true, count = 10, ratio = 0.5, name = 'short',"
+        "text = 'a string that does not fit into the object', list = {1, 2}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVue::Object obj = state->getObject("self.flag");
+  EXPECT_TRUE(obj.isInline());
+  EXPECT_EQ(obj.type(), ImVue::ObjectType::BOOLEAN);
+  EXPECT_TRUE(obj.as<bool>());
+
+  obj = state->getObject("self.count");
+  EXPECT_TRUE(obj.isInline());
+  EXPECT_EQ(obj.type(), ImVue::ObjectType::NUMBER);
+  EXPECT_EQ(obj.as<int>(), 10);
+  ASSERT_STREQ(obj.as<ImString>().get(), "10");
+
+  obj = state->getObject("self.ratio");
+  EXPECT_TRUE(obj.isInline());
+  EXPECT_EQ(obj.as<float>(), 0.5f);
+
+  obj = state->getObject("self.name");
+  EXPECT_TRUE(obj.isInline());
+  EXPECT_EQ(obj.type(), ImVue::ObjectType::STRING);
+  ASSERT_STREQ(obj.as<ImString>().get(), "short");
+
+  obj = state->getObject("self.missing");
+  EXPECT_TRUE(obj.valid());
+  EXPECT_TRUE(obj.isInline());
+  EXPECT_FALSE(obj);
+
+  obj = state->getObject("self.text");
+  EXPECT_FALSE(obj.isInline());
+  ASSERT_STREQ(obj.as<ImString>().get(), "a string that does not fit into the object");
+
+  ImVue::Object list = state->getObject("self.list");
+  EXPECT_FALSE(list.isInline());
+  EXPECT_EQ(list.type(), ImVue::ObjectType::ARRAY);
+
+  // inline values are passed back into the script state
+  list[1] = "value";
+  list[2] = 3;
+  obj = state->getObject("self.list[1] .. self.list[2]");
+  ASSERT_STREQ(obj.as<ImString>().get(), "value3");
+
+  ImVue::Object concat = state->getObject("function(a, b) return a .. b end");
+  ImVue::Object args[2] = {ImVue::Object::fromString("a", 1), ImVue::Object::fromInteger(1)};
+  ASSERT_TRUE(concat(args, &obj, 2, 1));
+  ASSERT_STREQ(obj.as<ImString>().get(), "a1");
+
+  // copies of long strings own their storage
+  ImVue::Object copy = ImVue::Object::fromString("a string that does not fit into the object", 42);
+  {
+    ImVue::Object other = copy;
+    copy = ImVue::Object::nil();
+    ASSERT_STREQ(other.as<ImString>().get(), "a string that does not fit into the object");
+  }
+  EXPECT_THROW(copy["key"], ImVue::ScriptError);
+}
+
+TEST_F(LuaScriptStateTest, TestObjectIteration)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"test\"/>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "list = {10, 20, 30, key = 'value', [10] = 100}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  const char* paths[] = {"self.list", "{10, 20, 30, key = 'value', [10] = 100}"};
+  for(int p = 0; p < 2; ++p) {
+    ImVue::Object list = state->getObject(paths[p]);
+    int index = 0;
+    int sum = 0;
+    bool hasKey = false;
+    for(ImVue::Object::iterator iter = list.begin(); iter != list.end(); ++iter, ++index) {
+      if(index < 3) {
+        // sequential part goes first and in order
+        EXPECT_EQ(iter.key.as<int>(), index + 1);
+        EXPECT_EQ(iter.value.as<int>(), (index + 1) * 10);
+      } else if(iter.key.type() == ImVue::ObjectType::STRING) {
+        ASSERT_STREQ(iter.key.as<ImString>().get(), "key");
+        ASSERT_STREQ(iter.value.as<ImString>().get(), "value");
+        hasKey = true;
+        continue;
+      }
+      sum += iter.value.as<int>();
+    }
+    EXPECT_EQ(index, 5);
+    EXPECT_EQ(sum, 160);
+    EXPECT_TRUE(hasKey);
+  }
+
+  ImVue::Object empty = state->getObject("{}");
+  EXPECT_TRUE(empty.begin() == empty.end());
+}
+
 TEST_F(LuaScriptStateTest, TestIfElseIf)
 {
   ImVue::Document document(ImVue::createContext(
@@ -264,13 +1111,70 @@ TEST_F(LuaScriptStateTest, TestIfElseIf)
   ASSERT_TRUE(windows[1]->enabled);
   ASSERT_FALSE(windows[2]->enabled);
 
-  luaL_dostring(L, "state.mode = 0");
-  renderDocument(document, 3);
+  luaL_dostring(L, "state.mode = 0");
+  renderDocument(document, 3);
+
+  windows = document.getChildren<ImVue::Window>("window");
+  ASSERT_TRUE(windows[0]->enabled);
+  ASSERT_FALSE(windows[1]->enabled);
+  ASSERT_FALSE(windows[2]->enabled);
+}
+
+TEST_F(LuaScriptStateTest, TestChildrenReconciliation)
+{
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        new ImVue::LuaScriptState(L)
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"w\">"
+      "<text-unformatted id=\"static\">static</text-unformatted>"
+      "<text-unformatted id=\"first\" v-if=\"self.mode == 0\">first</text-unformatted>"
+      "<text-unformatted id=\"second\" v-else=\"\">second</text-unformatted>"
+      "<text-unformatted v-for=\"item in self.items\">{{item}}</text-unformatted>"
+      "<text-unformatted id=\"keyed\" :key=\"self.key\">keyed</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "state = ImVue.new({"
+      "data = function() return { mode = 0, items = {'a', 'b'}, key = 'k' } end"
+    "})"
+    "return state"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVector<ImVue::Window*> windows = document.getChildren<ImVue::Window>("window");
+  ASSERT_EQ(windows.size(), 1);
+  ImVue::Window* window = windows[0];
+
+  ImVue::Element::Elements before = window->getChildren();
+  ImVector<ImVue::Element*> texts = window->getChildren<ImVue::Element>("text-unformatted", true);
+  EXPECT_EQ(texts.size(), 6);
+
+  window->invalidateFlags(ImVue::Element::BUILD);
+  renderDocument(document);
 
-  windows = document.getChildren<ImVue::Window>("window");
-  ASSERT_TRUE(windows[0]->enabled);
-  ASSERT_FALSE(windows[1]->enabled);
-  ASSERT_FALSE(windows[2]->enabled);
+  // every child is kept as is
+  ImVue::Element::Elements after = window->getChildren();
+  ASSERT_EQ(after.size(), before.size());
+  for(size_t i = 0; i < before.size(); ++i) {
+    EXPECT_EQ(after[i], before[i]);
+  }
+  ImVector<ImVue::Element*> rebuilt = window->getChildren<ImVue::Element>("text-unformatted", true);
+  ASSERT_EQ(rebuilt.size(), texts.size());
+  for(int i = 0; i < texts.size(); ++i) {
+    EXPECT_EQ(rebuilt[i], texts[i]);
+  }
+
+  // conditions are re-evaluated for the kept chain
+  luaL_dostring(L, "state.mode = 1");
+  renderDocument(document, 3);
+  ASSERT_FALSE(window->getChildren<ImVue::Element>("#first", true)[0]->enabled);
+  ASSERT_TRUE(window->getChildren<ImVue::Element>("#second", true)[0]->enabled);
+  EXPECT_EQ(window->getChildren()[1], before[1]);
 }
 
 typedef std::tuple<const char*, bool, int, int> MouseHandlerTestParam;
@@ -448,6 +1352,13 @@ TEST_F(LuaScriptStateTest, TestLifecycle)
     ASSERT_EQ(count, 1);
     getLuaVariable(L, "calls", "updated", count);
     ASSERT_EQ(count, 1);
+    // repeated changes are coalesced into a single update
+    luaL_dostring(L, "for i = 1, 100 do state.windowName = 'window' .. i; state.triggered = i % 2 == 0 end");
+    renderDocument(document, 2);
+    getLuaVariable(L, "calls", "beforeUpdate", count);
+    ASSERT_EQ(count, 2);
+    getLuaVariable(L, "calls", "updated", count);
+    ASSERT_EQ(count, 2);
   }
   getLuaVariable(L, "calls", "beforeDestroy", count);
   ASSERT_EQ(count, 1);
@@ -455,59 +1366,492 @@ TEST_F(LuaScriptStateTest, TestLifecycle)
   ASSERT_EQ(count, 1);
 }
 
-TEST_F(LuaScriptStateTest, TestDocumentParse) {
+TEST_F(LuaScriptStateTest, TestDocumentParse) {
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        new ImVue::LuaScriptState(L)
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"static\"></window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {} end"
+    "})"
+    "</script>";
+
+  document.parse(data);
+
+  data = "<template>"
+    "<window id=\"main\" :name=\"self.windowName\"><button>{{self.buttonName}}</button><button v-if=\"self.condition\">static</button></window>"
+    "</template>"
+    "<script>"
+    "state = ImVue.new({"
+      "data = function() return { windowName = 'window', buttonName = 'button', condition = false } end"
+    "})"
+    "return state"
+    "</script>";
+
+  document.parse(data);
+
+  renderDocument(document);
+
+  ImVector<ImVue::Window*> windows = document.getChildren<ImVue::Window>("#main");
+  ASSERT_EQ(windows.size(), 1);
+
+  ImVue::Window* window = windows[0];
+
+  ASSERT_STREQ(window->name, "window");
+
+  ImVector<ImVue::Button*> buttons = window->getChildren<ImVue::Button>("button");
+  ASSERT_EQ(buttons.size(), 2);
+
+  ASSERT_STREQ(buttons[0]->label, "button");
+  ASSERT_FALSE(buttons[1]->enabled);
+
+  luaL_dostring(L, "state.windowName = 'changed'; state.buttonName = 'ok'; state.condition = true");
+  renderDocument(document, 2);
+
+  ASSERT_STREQ(window->name, "changed");
+  ASSERT_STREQ(buttons[0]->label, "ok");
+  ASSERT_TRUE(buttons[1]->enabled);
+}
+
+TEST_F(LuaScriptStateTest, TestReferences) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"static\">"
+    "<input-text buf=\"fine\" buf-size=\"512\" ref=\"input\">console</input-text>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document);
+
+  ImVue::Object obj = state->getObject("self._refs.input");
+  EXPECT_EQ(obj.type(), ImVue::ObjectType::OBJECT);
+
+  obj = state->getObject("self._refs.input.buf");
+  EXPECT_EQ(obj.type(), ImVue::ObjectType::STRING);
+  ASSERT_STREQ(obj.as<ImString>().get(), "fine");
+}
+
+TEST_F(LuaScriptStateTest, TestKeyedRowsDiff) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"static\">"
+    "<input-text v-for=\"(i, k) in self.items\">{{k}}</input>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = { a = 1, b = 2, c = 3 }"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+  ImVector<ImVue::InputText*> inputs = document.getChildren<ImVue::InputText>("input-text", true);
+  ASSERT_EQ(inputs.size(), 3);
+  std::map<std::string, ImVue::InputText*> rows;
+  for(int i = 0; i < inputs.size(); ++i) {
+    rows[inputs[i]->label] = inputs[i];
+  }
+
+  // rows with the same key survive replacing the whole list
+  state->eval("self.items = { c = 30, d = 4, a = 10 }");
+  renderDocument(document, 3);
+  inputs = document.getChildren<ImVue::InputText>("input-text", true);
+  ASSERT_EQ(inputs.size(), 3);
+  int kept = 0;
+  for(int i = 0; i < inputs.size(); ++i) {
+    std::string label = inputs[i]->label;
+    EXPECT_NE(label, "b");
+    if(label == "a" || label == "c") {
+      EXPECT_EQ(inputs[i], rows[label]);
+      kept++;
+    }
+  }
+  EXPECT_EQ(kept, 2);
+}
+
+TEST_F(LuaScriptStateTest, TestVirtualList) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"virtual\">"
+    "<input-text v-for=\"item in self.items\" virtual item-height=\"20\">{{item}}</input-text>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local items = {}\n"
+    "for i = 1, 10000 do items[i] = 'row' .. i end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = items"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 3);
+
+  // only rows in the viewport are instantiated
+  ImVector<ImVue::InputText*> inputs = document.getChildren<ImVue::InputText>("input-text", true);
+  ASSERT_GT(inputs.size(), 0);
+  EXPECT_LT(inputs.size(), 100);
+  EXPECT_STREQ(inputs[0]->label, "row1");
+
+  state->eval("self.items[1] = 'changed'");
+  renderDocument(document, 2);
+  inputs = document.getChildren<ImVue::InputText>("input-text", true);
+  ASSERT_GT(inputs.size(), 0);
+  EXPECT_STREQ(inputs[0]->label, "changed");
+
+  state->eval("self.items = {'first', 'second'}");
+  renderDocument(document, 2);
+  inputs = document.getChildren<ImVue::InputText>("input-text", true);
+  ASSERT_EQ(inputs.size(), 2);
+  EXPECT_STREQ(inputs[0]->label, "first");
+  EXPECT_STREQ(inputs[1]->label, "second");
+}
+
+TEST_F(LuaScriptStateTest, TestElementPool) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Context* ctx = ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  );
+  ImVue::Document document(ctx);
+  ASSERT_NE((size_t)ctx->pool, 0);
+
+  const char* data = "<template>"
+    "<window name=\"pool\">"
+    "<input-text v-for=\"item in self.items\">{{item}}</input-text>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local items = {}\n"
+    "for i = 1, 100 do items[i] = 'row' .. i end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = items"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVue::ElementPool::Stats stats = ctx->pool->getStats();
+  EXPECT_GT(stats.allocations, 100);
+  EXPECT_GT(stats.used, 0);
+  EXPECT_GE(stats.reserved, stats.used);
+  size_t peak = stats.peak;
+
+  state->eval("self.items = {'first'}");
+  renderDocument(document, 2);
+  stats = ctx->pool->getStats();
+  EXPECT_LT(stats.allocations, 10);
+
+  // freed blocks are reused
+  state->eval("local items = {}\nfor i = 1, 100 do items[i] = 'row' .. i end\nself.items = items");
+  renderDocument(document, 2);
+  stats = ctx->pool->getStats();
+  EXPECT_LT(stats.peak, peak + peak / 10);
+  EXPECT_EQ(document.getChildren<ImVue::InputText>("input-text", true).size(), 100);
+}
+
+TEST_F(LuaScriptStateTest, TestElementPoolRelease) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  // contexts created with the custom font manager and style get the pool as well
+  ImVue::Context* ctx = ImVue::createContext(
+        ImVue::createElementFactory(),
+        state,
+        0,
+        0,
+        new ImVue::FontManager(),
+        new ImVue::Style()
+  );
+  ImVue::Document document(ctx);
+  ASSERT_NE((size_t)ctx->pool, 0);
+
+  const char* data = "<template>"
+    "<window name=\"pool release\">"
+    "<text-unformatted v-for=\"item in self.items\">{{item}}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local items = {}\n"
+    "for i = 1, 2000 do items[i] = 'row' .. i end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = items"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVue::ElementPool::Stats stats = ctx->pool->getStats();
+  size_t reserved = stats.reserved;
+  ASSERT_GT(reserved, 2 * 64 * 1024);
+
+  // pages emptied by the destroyed rows are released after the frame
+  state->eval("self.items = {'first'}");
+  renderDocument(document, 2);
+  stats = ctx->pool->getStats();
+  EXPECT_LT(stats.reserved, reserved / 2);
+  EXPECT_GE(stats.reserved, stats.used);
+
+  state->eval("local items = {}\nfor i = 1, 2000 do items[i] = 'row' .. i end\nself.items = items");
+  renderDocument(document, 2);
+  EXPECT_EQ(document.getChildren<ImVue::TextUnformatted>("text-unformatted", true).size(), 2000);
+  stats = ctx->pool->getStats();
+  EXPECT_LE(stats.reserved, reserved + 64 * 1024);
+}
+
+TEST_F(LuaScriptStateTest, TestStaticSubtrees) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"static\" id=\"static\">"
+    "<input-text id=\"a\">constant</input-text>"
+    "<input-text id=\"b\" class=\"label\">also constant</input-text>"
+    "</window>"
+    "<window name=\"dynamic\" id=\"dynamic\">"
+    "<input-text id=\"c\">constant</input-text>"
+    "<input-text id=\"d\">{{self.label}}</input-text>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "label = 'initial'"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  EXPECT_TRUE(document.getChildren<ImVue::Window>("#static")[0]->isStatic());
+  EXPECT_TRUE(document.getChildren<ImVue::InputText>("#a", true)[0]->isStatic());
+  EXPECT_TRUE(document.getChildren<ImVue::InputText>("#b", true)[0]->isStatic());
+  EXPECT_FALSE(document.getChildren<ImVue::Window>("#dynamic")[0]->isStatic());
+  EXPECT_TRUE(document.getChildren<ImVue::InputText>("#c", true)[0]->isStatic());
+  EXPECT_FALSE(document.getChildren<ImVue::InputText>("#d", true)[0]->isStatic());
+
+  state->eval("self.label = 'changed'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(document.getChildren<ImVue::InputText>("#d", true)[0]->label, "changed");
+  EXPECT_STREQ(document.getChildren<ImVue::InputText>("#a", true)[0]->label, "constant");
+}
+
+TEST_F(LuaScriptStateTest, TestDrawCache) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"cached\">"
+    "<group cache>"
+    "<button>first</button>"
+    "<input-text id=\"label\">{{self.label}}</input-text>"
+    "</group>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "label = 'initial'"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 3);
+  int recorded = ImGui::GetDrawData()->TotalVtxCount;
+  ASSERT_GT(recorded, 0);
+
+  // replayed output matches the recorded one
+  renderDocument(document, 2);
+  EXPECT_EQ(ImGui::GetDrawData()->TotalVtxCount, recorded);
+
+  state->eval("self.label = 'changed'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(document.getChildren<ImVue::InputText>("#label", true)[0]->label, "changed");
+  int updated = ImGui::GetDrawData()->TotalVtxCount;
+  renderDocument(document, 2);
+  EXPECT_EQ(ImGui::GetDrawData()->TotalVtxCount, updated);
+}
+
+TEST_F(LuaScriptStateTest, TestDrawCachePopup) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
   ImVue::Document document(ImVue::createContext(
         ImVue::createElementFactory(),
-        new ImVue::LuaScriptState(L)
+        state
   ));
 
   const char* data = "<template>"
-    "<window name=\"static\"></window>"
+    "<window name=\"cached-combo\">"
+    "<group cache>"
+    "<combo id=\"combo\" label=\"combo\" preview-value=\"first\">"
+    "<selectable>first</selectable>"
+    "<selectable>second</selectable>"
+    "</combo>"
+    "</group>"
+    "</window>"
     "</template>"
     "<script>"
-    "return ImVue.new({"
-      "data = function() return {} end"
-    "})"
+    "return ImVue.new({})\n"
     "</script>";
 
   document.parse(data);
+  renderDocument(document, 3);
 
-  data = "<template>"
-    "<window id=\"main\" :name=\"self.windowName\"><button>{{self.buttonName}}</button><button v-if=\"self.condition\">static</button></window>"
+  ImVue::Combo* combo = document.getChildren<ImVue::Combo>("#combo", true)[0];
+  ImGuiWindow* window = ImGui::FindWindowByName("cached-combo");
+  ASSERT_NE(window, (ImGuiWindow*)NULL);
+
+  simulateMouseClick(window->Pos - window->Scroll + combo->pos + combo->computedSize * 0.5f, document);
+  ImGuiWindow* popup = ImGui::FindWindowByName("##Combo_00");
+  ASSERT_NE(popup, (ImGuiWindow*)NULL);
+  EXPECT_TRUE(popup->Active);
+
+  // the dropdown is still submitted when the mouse leaves the cached element
+  ImGui::GetIO().MousePos = popup->Pos + popup->Size * 0.5f;
+  renderDocument(document, 3);
+  EXPECT_TRUE(popup->Active);
+}
+
+TEST_F(LuaScriptStateTest, TestNeedsRedraw) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"idle\">"
+    "<button>static</button>"
+    "<span id=\"label\">{{self.label}}</span>"
+    "</window>"
     "</template>"
     "<script>"
-    "state = ImVue.new({"
-      "data = function() return { windowName = 'window', buttonName = 'button', condition = false } end"
-    "})"
-    "return state"
+    "return ImVue.new({"
+      "data = function() return {"
+        "label = 'initial'"
+      "} end"
+    "})\n"
     "</script>";
 
   document.parse(data);
+  EXPECT_TRUE(document.needsRedraw());
+  renderDocument(document, 3);
+  EXPECT_FALSE(document.needsRedraw());
 
+  state->eval("self.label = 'changed'");
+  EXPECT_TRUE(document.needsRedraw());
   renderDocument(document);
+  EXPECT_TRUE(document.needsRedraw());
+  renderDocument(document, 2);
+  EXPECT_FALSE(document.needsRedraw());
 
-  ImVector<ImVue::Window*> windows = document.getChildren<ImVue::Window>("#main");
-  ASSERT_EQ(windows.size(), 1);
+  // input keeps the document active for a couple of frames
+  ImGui::GetIO().MouseWheel = 1.0f;
+  renderDocument(document);
+  ImGui::GetIO().MouseWheel = 0.0f;
+  EXPECT_TRUE(document.needsRedraw());
+  renderDocument(document, 2);
+  EXPECT_FALSE(document.needsRedraw());
+}
 
-  ImVue::Window* window = windows[0];
+TEST_F(LuaScriptStateTest, TestMouseEvents) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
 
-  ASSERT_STREQ(window->name, "window");
+  const char* data = "<template>"
+    "<window name=\"events\">"
+    "<button id=\"target\" v-if=\"self.visible\" v-on:mouseover=\"self.over = self.over + 1\" v-on:mouseout=\"self.out = self.out + 1\">hover</button>"
+    "<button id=\"other\" v-on:mouseover=\"self.other = self.other + 1\">other</button>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return {"
+        "over = 0, out = 0, other = 0, visible = true"
+      "} end"
+    "})\n"
+    "</script>";
 
-  ImVector<ImVue::Button*> buttons = window->getChildren<ImVue::Button>("button");
-  ASSERT_EQ(buttons.size(), 2);
+  document.parse(data);
+  renderDocument(document, 2);
 
-  ASSERT_STREQ(buttons[0]->label, "button");
-  ASSERT_FALSE(buttons[1]->enabled);
+  ImVue::Button* target = document.getChildren<ImVue::Button>("#target", true)[0];
+  ImGuiWindow* window = ImGui::FindWindowByName("events");
+  ASSERT_NE(window, (ImGuiWindow*)NULL);
 
-  luaL_dostring(L, "state.windowName = 'changed'; state.buttonName = 'ok'; state.condition = true");
+  ImGuiIO& io = ImGui::GetIO();
+  io.MousePos = window->Pos - window->Scroll + target->pos + target->computedSize * 0.5f;
+  renderDocument(document, 3);
+  int over = state->getObject("self.over").as<int>();
+  EXPECT_GT(over, 0);
+  EXPECT_EQ(state->getObject("self.out").as<int>(), 0);
+  EXPECT_EQ(state->getObject("self.other").as<int>(), 0);
+
+  // mouseover fires on every hovered frame
   renderDocument(document, 2);
+  EXPECT_EQ(state->getObject("self.over").as<int>(), over + 2);
 
-  ASSERT_STREQ(window->name, "changed");
-  ASSERT_STREQ(buttons[0]->label, "ok");
-  ASSERT_TRUE(buttons[1]->enabled);
+  io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
+  renderDocument(document, 3);
+  EXPECT_EQ(state->getObject("self.over").as<int>(), over + 2);
+  EXPECT_EQ(state->getObject("self.out").as<int>(), 1);
+
+  // element hidden while hovered is not rendered, so it gets no mouseout
+  io.MousePos = window->Pos - window->Scroll + target->pos + target->computedSize * 0.5f;
+  renderDocument(document, 3);
+  state->eval("self.visible = false");
+  renderDocument(document, 3);
+  EXPECT_EQ(state->getObject("self.out").as<int>(), 1);
+  EXPECT_EQ(document.getChildren<ImVue::Button>("#target", true).size(), 0);
+  io.MousePos = ImVec2(-FLT_MAX, -FLT_MAX);
 }
 
-TEST_F(LuaScriptStateTest, TestReferences) {
+TEST_F(LuaScriptStateTest, TestComponentMouseHandlers) {
   ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
   ImVue::Document document(ImVue::createContext(
         ImVue::createElementFactory(),
@@ -515,25 +1859,35 @@ TEST_F(LuaScriptStateTest, TestReferences) {
   ));
 
   const char* data = "<template>"
-    "<window name=\"static\">"
-    "<input-text buf=\"fine\" buf-size=\"512\" ref=\"input\">console</input-text>"
+    "<window name=\"component events\">"
+    "<clickable v-if=\"self.visible\" v-on:click=\"self.clicks = self.clicks + 1\" v-on:mouseout=\"self.out = self.out + 1\"/>"
     "</window>"
     "</template>"
     "<script>"
+    "local Clickable = ImVue.component('clickable', {"
+      "template = '<button id=\"inner\">click</button>'"
+    "})\n"
     "return ImVue.new({"
-      "data = function() return {} end"
+      "components = { Clickable },"
+      "data = function() return {"
+        "clicks = 0, out = 0, visible = true"
+      "} end"
     "})\n"
     "</script>";
 
   document.parse(data);
-  renderDocument(document);
+  renderDocument(document, 2);
+  ASSERT_EQ(document.getChildren<ImVue::Button>("#inner", true).size(), 1);
 
-  ImVue::Object obj = state->getObject("self._refs.input");
-  EXPECT_EQ(obj.type(), ImVue::ObjectType::OBJECT);
+  // component context is deleted before the element itself
+  state->eval("self.visible = false");
+  renderDocument(document, 2);
+  EXPECT_EQ(document.getChildren<ImVue::Button>("#inner", true).size(), 0);
 
-  obj = state->getObject("self._refs.input.buf");
-  EXPECT_EQ(obj.type(), ImVue::ObjectType::STRING);
-  ASSERT_STREQ(obj.as<ImString>().get(), "fine");
+  state->eval("self.visible = true");
+  renderDocument(document, 2);
+  EXPECT_EQ(document.getChildren<ImVue::Button>("#inner", true).size(), 1);
+  EXPECT_EQ(state->getObject("self.clicks").as<int>(), 0);
 }
 
 TEST_F(LuaScriptStateTest, TestListModifications) {
@@ -616,6 +1970,87 @@ TEST_F(LuaScriptStateTest, TestListModifications) {
   EXPECT_STREQ(inputs[0]->key, "aye");
 }
 
+TEST_F(LuaScriptStateTest, TestListSplices) {
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"splices\">"
+    "<button v-for=\"item in self.items\">{{tick(item.name)}}</button>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "evals = 0\n"
+    "function tick(value) evals = evals + 1; return value end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "items = {"
+          "{ name = 'a' }, { name = 'b' }"
+        "}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+  ImVector<ImVue::Button*> buttons = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(buttons.size(), 2);
+
+  int evals = 0;
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 2);
+
+  // append creates a single row
+  state->eval("self.items:insert({ name = 'c' })");
+  renderDocument(document, 2);
+  ImVector<ImVue::Button*> appended = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(appended.size(), 3);
+  EXPECT_EQ(appended[0], buttons[0]);
+  EXPECT_EQ(appended[1], buttons[1]);
+  EXPECT_STREQ(appended[2]->label, "c");
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 3);
+
+  // nested change updates only the affected row
+  state->eval("self.items[2].name = 'x'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(appended[1]->label, "x");
+  lua_getglobal(L, "evals");
+  evals = lua_tointeger(L, -1);
+  lua_pop(L, 1);
+  EXPECT_EQ(evals, 4);
+
+  // removal keeps the rest of the rows
+  state->eval("self.items:remove(1)");
+  renderDocument(document, 2);
+  buttons = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(buttons.size(), 2);
+  EXPECT_EQ(buttons[0], appended[1]);
+  EXPECT_EQ(buttons[1], appended[2]);
+  EXPECT_STREQ(buttons[0]->label, "x");
+  EXPECT_STREQ(buttons[1]->label, "c");
+
+  // shifted rows pick up new item paths
+  state->eval("self.items[1].name = 'y'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(buttons[0]->label, "y");
+
+  // set replaces the row value
+  state->eval("self.items[2] = { name = 'z' }");
+  renderDocument(document, 2);
+  buttons = document.getChildren<ImVue::Button>("button", true);
+  ASSERT_EQ(buttons.size(), 2);
+  EXPECT_EQ(buttons[1], appended[2]);
+  EXPECT_STREQ(buttons[1]->label, "z");
+}
+
 typedef std::tuple<const char*, const char*, int> VForParam;
 
 class LuaVForTest : public ::testing::Test, public testing::WithParamInterface<VForParam> {
@@ -737,6 +2172,195 @@ TEST_F(LuaScriptStateTest, TestComponentReactivity)
   EXPECT_STREQ(local[0]->text, "updated");
 }
 
+TEST_F(LuaScriptStateTest, TestReregisteredAttribute)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::ElementFactory* factory = ImVue::createElementFactory();
+  ImVue::Document document(ImVue::createContext(
+        factory,
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"test\">"
+    "<text-unformatted id=\"label\">{{ self.label }}</text-unformatted>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "return ImVue.new({"
+      "data = function() return { label = 'first' } end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  // replaces the text reader cached in the attributes table
+  factory->element<ImVue::TextUnformatted>("text-unformatted")
+    .text(&ImVue::TextUnformatted::text);
+
+  state->eval("self.label = 'second'");
+  renderDocument(document, 2);
+
+  ImVector<ImVue::TextUnformatted*> labels = document.getChildren<ImVue::TextUnformatted>("#label", true);
+  ASSERT_EQ(labels.size(), 1);
+  EXPECT_STREQ(labels[0]->text, "second");
+}
+
+TEST_F(LuaScriptStateTest, TestSharedComponentTemplate)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"list\">"
+    "<list-item v-for=\"i in self.items\" :label=\"i\"/>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local Item = ImVue.component('list-item', {"
+      "props = { label = { type = ImVue_String } },"
+      "template = '<text-unformatted id=\"item\">{{ self.label }}</text-unformatted>'"
+    "})\n"
+    "return ImVue.new({"
+      "components = { Item },"
+      "data = function() return {"
+        "items = {'first', 'second', 'last'}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[0]->text, "first");
+  EXPECT_STREQ(items[2]->text, "last");
+
+  // instances reference the same parsed template
+  EXPECT_EQ(items[0]->node(), items[1]->node());
+  EXPECT_EQ(items[1]->node(), items[2]->node());
+  EXPECT_EQ(document.getCachedTemplatesCount(), 1u);
+
+  state->eval("self.items[2] = 'changed'");
+  renderDocument(document, 3);
+  items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[1]->text, "changed");
+
+  // template is released with the last instance
+  state->eval("self.items = {}");
+  renderDocument(document, 2);
+  EXPECT_EQ(document.getChildren<ImVue::TextUnformatted>("#item", true).size(), 0);
+  EXPECT_EQ(document.getCachedTemplatesCount(), 0u);
+
+  state->eval("self.items = {'again'}");
+  renderDocument(document, 2);
+  items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 1);
+  EXPECT_STREQ(items[0]->text, "again");
+  EXPECT_EQ(document.getCachedTemplatesCount(), 1u);
+}
+
+TEST_F(LuaScriptStateTest, TestComponentPrototype)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"list\">"
+    "<counter v-for=\"i in self.items\" :label=\"i\"/>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local Counted = {"
+      "data = function() return { count = 0 } end,"
+      "increase = function(self) self.count = self.count + 1 end"
+    "}\n"
+    "local Counter = ImVue.component('counter', {"
+      "mixins = { Counted },"
+      "props = { label = { type = ImVue_String } },"
+      "data = function() return { mark = '#' } end,"
+      "format = function(self) return self.mark .. self.label .. self.count end,"
+      "created = function(self) if self.label == 'second' then self:increase() end end,"
+      "template = '<text-unformatted id=\"item\">{{ self:format() }}</text-unformatted>'"
+    "})\n"
+    "return ImVue.new({"
+      "components = { Counter },"
+      "data = function() return {"
+        "items = {'first', 'second', 'last'}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  // methods come from the shared prototype, data is evaluated per instance
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[0]->text, "#first0");
+  EXPECT_STREQ(items[1]->text, "#second1");
+  EXPECT_STREQ(items[2]->text, "#last0");
+
+  state->eval("self.items[4] = 'new'");
+  renderDocument(document, 3);
+  items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 4);
+  EXPECT_STREQ(items[3]->text, "#new0");
+}
+
+TEST_F(LuaScriptStateTest, TestFunctionalComponent)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+  ));
+
+  const char* data = "<template>"
+    "<window name=\"list\">"
+    "<item-label v-for=\"i in self.items\" :label=\"i\"/>"
+    "</window>"
+    "</template>"
+    "<script>"
+    "local Label = ImVue.component('item-label', {"
+      "functional = true,"
+      "props = { label = { type = ImVue_String, required = true } },"
+      "template = '<text-unformatted id=\"item\">{{ label }}</text-unformatted>'"
+    "})\n"
+    "return ImVue.new({"
+      "components = { Label },"
+      "data = function() return {"
+        "items = {'first', 'second', 'last'}"
+      "} end"
+    "})\n"
+    "</script>";
+
+  document.parse(data);
+  renderDocument(document, 2);
+
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[0]->text, "first");
+  EXPECT_STREQ(items[2]->text, "last");
+  // rendered with the document state, no per instance state is created
+  EXPECT_EQ(items[0]->getState(), state);
+
+  state->eval("self.items[2] = 'changed'");
+  renderDocument(document, 3);
+  items = document.getChildren<ImVue::TextUnformatted>("#item", true);
+  ASSERT_EQ(items.size(), 3);
+  EXPECT_STREQ(items[1]->text, "changed");
+}
+
 TEST_F(LuaScriptStateTest, TestComponentCreationError)
 {
   ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
@@ -803,6 +2427,63 @@ TEST_F(LuaScriptStateTest, TestComponentLifecycle)
   EXPECT_EQ(count, 1);
 }
 
+TEST_F(LuaScriptStateTest, TestManyAttributes)
+{
+  ImVue::LuaScriptState* state = new ImVue::LuaScriptState(L);
+  ImVue::Document document(ImVue::createContext(
+        ImVue::createElementFactory(),
+        state
+        ));
+
+  // bindings placed after the 62nd attribute share the overflow dirty bit
+  std::stringstream ss;
+  ss << "<template><window name=\"attributes\"><text-unformatted";
+  for(int i = 0; i < 64; ++i) {
+    ss << " a" << i << "=\"\"";
+  }
+  ss << " :id=\"tick('id', self.id)\" :key=\"tick('key', self.key)\">{{self.text}}</text-unformatted>"
+    "</window></template>"
+    "<script>"
+    "evals = {}\n"
+    "function tick(name, value) evals[name] = (evals[name] or 0) + 1; return value end\n"
+    "return ImVue.new({"
+      "data = function() return {"
+        "id = 'first', key = 'k', text = 'text'"
+      "} end"
+    "})"
+    "</script>";
+
+  int count = 0;
+  std::string data = ss.str();
+  document.parse(data.c_str());
+  renderDocument(document);
+
+  ImVector<ImVue::TextUnformatted*> items = document.getChildren<ImVue::TextUnformatted>("text-unformatted", true);
+  ASSERT_EQ(items.size(), 1);
+  EXPECT_STREQ(items[0]->id, "first");
+  EXPECT_STREQ(items[0]->key, "k");
+  getLuaVariable(L, "evals", "id", count);
+  EXPECT_EQ(count, 1);
+  getLuaVariable(L, "evals", "key", count);
+  EXPECT_EQ(count, 1);
+
+  // only the changed overflow attribute is read again
+  state->eval("self.id = 'second'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(items[0]->id, "second");
+  EXPECT_STREQ(items[0]->key, "k");
+  getLuaVariable(L, "evals", "id", count);
+  EXPECT_EQ(count, 2);
+  getLuaVariable(L, "evals", "key", count);
+  EXPECT_EQ(count, 1);
+
+  state->eval("self.text = 'updated'");
+  renderDocument(document, 2);
+  EXPECT_STREQ(items[0]->text, "updated");
+  getLuaVariable(L, "evals", "id", count);
+  EXPECT_EQ(count, 2);
+}
+
 typedef std::tuple<const char*, const char*, bool> ComponentPropsParam;
 
 class LuaComponentPropsTest : public ::testing::Test, public testing::WithParamInterface<ComponentPropsParam> {
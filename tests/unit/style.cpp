@@ -628,6 +628,38 @@ TEST_F(TestStyles, FontFamily) {
   }
 }
 
+TEST_F(TestStyles, StateDependencies)
+{
+  const char* doc = "<style>"
+      ".hoverable:hover { color: #FFCC00; }"
+      ".list:active .item { color: #FFCC00; }"
+    "</style>"
+    "<template>"
+      "<test id='plain'/>"
+      "<test id='hoverable' class='hoverable'/>"
+      "<test id='list' class='list'>"
+        "<test id='item' class='item'/>"
+      "</test>"
+    "</template>"
+  ;
+  ImVue::Document& d = createDoc(doc);
+  renderDocument(d);
+
+  TestElement* plain = d.getChildren<TestElement>("#plain", true)[0];
+  TestElement* hoverable = d.getChildren<TestElement>("#hoverable", true)[0];
+  TestElement* list = d.getChildren<TestElement>("#list", true)[0];
+  TestElement* item = d.getChildren<TestElement>("#item", true)[0];
+  ImVue::Style* style = d.context()->style;
+
+  EXPECT_EQ(style->stateDependency(plain, ImVue::Element::HOVERED), 0);
+  EXPECT_EQ(style->stateDependency(hoverable, ImVue::Element::HOVERED), ImVue::Style::STATE_SELF);
+  EXPECT_EQ(style->stateDependency(hoverable, ImVue::Element::ACTIVE), 0);
+  EXPECT_EQ(style->stateDependency(list, ImVue::Element::ACTIVE), ImVue::Style::STATE_DESCENDANTS);
+  EXPECT_TRUE(style->dependsOnAncestorState(item, ImVue::Element::ACTIVE));
+  EXPECT_FALSE(style->dependsOnAncestorState(item, ImVue::Element::HOVERED));
+  EXPECT_FALSE(style->dependsOnAncestorState(plain, ImVue::Element::ACTIVE));
+}
+
 typedef std::tuple<const char*, int*, const char*, const char*> SelectionTestParam;
 
 class SelectionTest : public ::testing::Test, public testing::WithParamInterface<SelectionTestParam> {